@@ -0,0 +1,336 @@
+#include "bmp8.h"
+#include "bmp24.h"
+#include "equalize24.h"
+#include "median.h"
+#include "rank.h"
+#include "morphology.h"
+#include "gradient.h"
+#include "canny.h"
+#include "imagef.h"
+#include "gray.h"
+#include "colormatrix.h"
+#include "levels.h"
+#include "histmatch.h"
+#include "resize.h"
+#include "orient.h"
+#include "warp.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// -------------------- HEADER ---------------------------
+//  Name : benchmark.c
+//  Goal : measure the throughput of every 24-bit filter on the interleaved, planar and BGRA layouts,
+//         and check that all layouts give the same result, then compare a filter chain run on bytes
+//         with the same chain run on float planes, and time the resize filters and the affine warp
+//  Usage : benchmark <image.bmp> [iterations]
+//  Authors : Amel Boulhamane and Tom Hausmann
+//
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments
+//
+// --------------------------------------------------------
+
+
+typedef enum {
+    BENCH_NEGATIVE, BENCH_GRAYSCALE, BENCH_BRIGHTNESS, BENCH_BOX_BLUR, BENCH_GAUSSIAN_BLUR,
+    BENCH_OUTLINE, BENCH_EMBOSS, BENCH_SHARPEN, BENCH_EQUALIZE, BENCH_MEDIAN, BENCH_RANK,
+    BENCH_MORPHOLOGY, BENCH_GRADIENT, BENCH_CANNY, BENCH_GRAY8, BENCH_COLOR_MATRIX, BENCH_AUTO_LEVELS, BENCH_HIST_MATCH,
+    BENCH_ROTATE_90, BENCH_ROTATE_180, BENCH_COUNT
+} t_bench_filter;
+
+static const char *benchNames[BENCH_COUNT] = {
+    "negative", "grayscale", "brightness", "box blur", "gaussian blur",
+    "outline", "emboss", "sharpen", "equalize", "median r=2", "rank median 5x5",
+    "opening 7x7", "sobel gradient", "canny", "gray to 8-bit", "color matrix", "auto levels", "histogram match",
+    "rotate 90", "rotate 180"
+};
+
+
+/// @brief Wall-clock time in seconds (CPU time when OpenMP is not available).
+static double now(void) {
+#ifdef _OPENMP
+    return omp_get_wtime();
+#else
+    return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+
+/// @brief Runs one filter on an image.
+/// @param img : The image, modified in place for the filters that do so
+/// @param filter : The filter to run
+/// @return The 8-bit result for the gradient, Canny and gray conversion, NULL otherwise
+static t_bmp8 *runFilter(t_bmp24 *img, t_bench_filter filter) {
+    switch (filter) {
+        case BENCH_NEGATIVE: bmp24_negative(img); break;
+        case BENCH_GRAYSCALE: bmp24_grayscale(img); break;
+        case BENCH_BRIGHTNESS: bmp24_brightness(img, 40); break;
+        case BENCH_BOX_BLUR: bmp24_boxBlur(img); break;
+        case BENCH_GAUSSIAN_BLUR: bmp24_gaussianBlur(img); break;
+        case BENCH_OUTLINE: bmp24_outline(img); break;
+        case BENCH_EMBOSS: bmp24_emboss(img); break;
+        case BENCH_SHARPEN: bmp24_sharpen(img); break;
+        case BENCH_EQUALIZE: bmp24_equalize(img); break;
+        case BENCH_MEDIAN: bmp24_median(img, 2); break;
+        case BENCH_RANK: bmp24_rankFilter(img, 5, RANK_MEDIAN); break;
+        case BENCH_MORPHOLOGY: bmp24_morphology(img, 7, 7, MORPH_OPEN); break;
+        case BENCH_GRADIENT: return bmp24_gradient(img, GRADIENT_SOBEL, GRADIENT_L1, NULL);
+        case BENCH_CANNY: return bmp24_canny(img, 20, 50);
+        case BENCH_GRAY8: return bmp24_toGray8(img, GRAY_BT601);
+        case BENCH_COLOR_MATRIX: {
+            t_color_matrix total, step;
+            color_gains(&total, 1.1f, 1.0f, 0.9f);
+            color_saturation(&step, 1.3f);
+            color_compose(&total, &step, &total);
+            color_sepia(&step);
+            color_compose(&total, &step, &total);
+            bmp24_colorMatrix(img, &total);
+            break;
+        }
+        case BENCH_AUTO_LEVELS: bmp24_autoLevels(img, 0.5f, LEVELS_LUMINANCE); break;
+        case BENCH_HIST_MATCH: {
+            // Triangular target distribution peaking at mid gray
+            unsigned int hist[256];
+            t_hist_target target;
+            for (int v = 0; v < 256; v++) hist[v] = 128 - abs(v - 128) + 1;
+            if (histmatch_fromHistogram(hist, &target) == 0) bmp24_matchHistogram(img, &target);
+            break;
+        }
+        case BENCH_ROTATE_90: bmp24_orient(img, ORIENT_ROTATE_90); break;
+        case BENCH_ROTATE_180: bmp24_orient(img, ORIENT_ROTATE_180); break;
+        default: break;
+    }
+    return NULL;
+}
+
+
+/// @brief Times a filter on a given layout, one fresh copy of the source per iteration.
+/// @param src : The source image (left untouched)
+/// @param layout : The layout the filter runs on
+/// @param filter : The filter to run
+/// @param iterations : Number of runs
+/// @param result : Receives the image of the last run, converted back to the interleaved layout
+/// @param result8 : Receives the 8-bit output of the last run, if any
+/// @return The average time of one run in seconds, or -1 on failure
+static double timeFilter(t_bmp24 *src, t_bmp24_layout layout, t_bench_filter filter, int iterations,
+                         t_bmp24 **result, t_bmp8 **result8) {
+    double total = 0.0;
+    *result = NULL;
+    *result8 = NULL;
+
+    for (int it = 0; it < iterations; it++) {
+        t_bmp24 *img = bmp24_copy(src);
+        if (!img || bmp24_setLayout(img, layout) != 0) {
+            bmp24_free(img);
+            return -1.0;
+        }
+
+        double start = now();
+        t_bmp8 *out = runFilter(img, filter);
+        total += now() - start;
+
+        if (it == iterations - 1) {
+            bmp24_setLayout(img, BMP24_INTERLEAVED);
+            *result = img;
+            *result8 = out;
+        } else {
+            bmp24_free(img);
+            if (out) bmp8_free(out);
+        }
+    }
+    return total / iterations;
+}
+
+
+/// @brief Checks that two results of the same filter are identical.
+static int sameResult(t_bmp24 *a, t_bmp24 *b, t_bmp8 *a8, t_bmp8 *b8) {
+    if (a8 || b8) {
+        return a8 && b8 && a8->dataSize == b8->dataSize && memcmp(a8->data, b8->data, a8->dataSize) == 0;
+    }
+    for (int y = 0; y < a->height; y++) {
+        for (int x = 0; x < a->width; x++) {
+            t_pixel p = a->data[y][x], q = b->data[y][x];
+            if (p.red != q.red || p.green != q.green || p.blue != q.blue) return 0;
+        }
+    }
+    return 1;
+}
+
+
+/// @brief Times the chain box blur, sharpen, emboss on bytes (rounded after every filter) and on float
+/// planes (rounded once), and prints how far the byte result is from the float one.
+/// @param src : The source image (left untouched)
+/// @param iterations : Number of runs
+/// @return 0 on success, -1 on failure
+static int benchChain(t_bmp24 *src, int iterations) {
+    static const t_image_kernel chain[] = {IMAGE_BOX_BLUR, IMAGE_SHARPEN, IMAGE_EMBOSS};
+    int steps = (int)(sizeof(chain) / sizeof(chain[0]));
+    double megapixels = (double)src->width * src->height / 1e6;
+    double tBytes = 0.0, tFloat = 0.0;
+    t_bmp24 *bytes = NULL, *precise = NULL;
+    long negatives = 0;
+
+    for (int it = 0; it < iterations; it++) {
+        bmp24_free(bytes);
+        bmp24_free(precise);
+        bytes = bmp24_copy(src);
+        precise = bmp24_copy(src);
+        if (!bytes || !precise) break;
+
+        double start = now();
+        t_image view;
+        if (image_fromBmp24(bytes, &view) != 0) break;
+        for (int k = 0; k < steps; k++) {
+            image_convolve(&view, image_presetKernel(chain[k]), 3, 1, IMAGE_ROUND);
+        }
+        image_free(&view);
+        tBytes += now() - start;
+
+        start = now();
+        t_image_float *fimg = image_floatFromBmp24(precise);
+        if (!fimg) break;
+        for (int k = 0; k < steps; k++) image_floatPreset(fimg, chain[k]);
+        image_floatToBmp24(fimg, precise, IMAGE_QUANTIZE_CLAMP);
+        tFloat += now() - start;
+
+        negatives = 0;
+        for (size_t i = 0; i < (size_t)fimg->planes * fimg->width * fimg->height; i++) {
+            if (fimg->data[i] < 0.0f) negatives++;
+        }
+        image_floatFree(fimg);
+    }
+    if (!bytes || !precise || tFloat == 0.0) {
+        fprintf(stderr, "Error: filter chain failed\n");
+        bmp24_free(bytes);
+        bmp24_free(precise);
+        return -1;
+    }
+
+    long total = 0;
+    int worst = 0;
+    for (int y = 0; y < src->height; y++) {
+        for (int x = 0; x < src->width; x++) {
+            t_pixel p = bytes->data[y][x], q = precise->data[y][x];
+            int d[3] = {abs(p.red - q.red), abs(p.green - q.green), abs(p.blue - q.blue)};
+            for (int c = 0; c < 3; c++) {
+                total += d[c];
+                if (d[c] > worst) worst = d[c];
+            }
+        }
+    }
+
+    printf("\nchain box blur > sharpen > emboss\n");
+    printf("%-18s %14s %14s %10s\n", "precision", "throughput", "mean error", "max error");
+    printf("%-18s %9.1f MP/s %14.3f %10d\n", "8-bit per step", megapixels * iterations / tBytes,
+           (double)total / (3.0 * src->width * src->height), worst);
+    printf("%-18s %9.1f MP/s %14s %10s\n", "float, 1 rounding", megapixels * iterations / tFloat, "reference", "-");
+    printf("negative samples kept by the float chain: %ld\n", negatives);
+
+    bmp24_free(bytes);
+    bmp24_free(precise);
+    return 0;
+}
+
+
+/// @brief Times every resize filter halving the image, and a 3 degree rotation (deskew) by the affine warp,
+/// on the three layouts, and checks that all the layouts give the same result.
+/// @param src : The source image (left untouched)
+/// @param iterations : Number of runs
+/// @return The number of failures
+static int benchResize(t_bmp24 *src, int iterations) {
+    static const char *names[] = {"nearest", "bilinear", "bicubic", "area", "warp 3 degrees"};
+    static const t_bmp24_layout layouts[] = {BMP24_INTERLEAVED, BMP24_PLANAR, BMP24_BGRA};
+    double megapixels = (double)src->width * src->height / 1e6;
+    int width = src->width > 1 ? src->width / 2 : 1, height = src->height > 1 ? src->height / 2 : 1;
+    int failures = 0;
+    t_pixel white = {255, 255, 255};
+    t_affine deskew;
+    affine_rotate(&deskew, 3.0, src->width / 2.0, src->height / 2.0);
+
+    printf("\nresize to %dx%d, warp to the same size (source megapixels per second)\n", width, height);
+    printf("%-18s %14s %14s %14s %8s\n", "filter", "interleaved", "planar", "bgra", "same");
+    for (int f = RESIZE_NEAREST; f <= RESIZE_AREA + 1; f++) {
+        t_bmp24 *results[3] = {NULL, NULL, NULL};
+        double times[3] = {0.0, 0.0, 0.0};
+        int ok = 1;
+
+        for (int l = 0; l < 3 && ok; l++) {
+            t_bmp24 *img = bmp24_copy(src);
+            if (!img || bmp24_setLayout(img, layouts[l]) != 0) ok = 0;
+            for (int it = 0; it < iterations && ok; it++) {
+                bmp24_free(results[l]);
+                double start = now();
+                results[l] = f <= RESIZE_AREA ? bmp24_resize(img, width, height, (t_resize_filter)f)
+                                              : bmp24_warp(img, &deskew, src->width, src->height, white);
+                times[l] += now() - start;
+                if (!results[l]) ok = 0;
+            }
+            if (ok) bmp24_setLayout(results[l], BMP24_INTERLEAVED);
+            bmp24_free(img);
+        }
+
+        if (!ok) {
+            fprintf(stderr, "Error: %s failed\n", names[f]);
+            failures++;
+        } else {
+            int same = sameResult(results[0], results[1], NULL, NULL) && sameResult(results[0], results[2], NULL, NULL);
+            if (!same) failures++;
+            printf("%-18s %9.1f MP/s %9.1f MP/s %9.1f MP/s %8s\n", names[f], megapixels * iterations / times[0],
+                   megapixels * iterations / times[1], megapixels * iterations / times[2], same ? "yes" : "NO");
+        }
+        for (int l = 0; l < 3; l++) bmp24_free(results[l]);
+    }
+    return failures;
+}
+
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage : %s <image.bmp> [iterations]\n", argv[0]);
+        return 1;
+    }
+    int iterations = argc > 2 ? atoi(argv[2]) : 5;
+    if (iterations < 1) iterations = 1;
+
+    t_bmp24 *src = bmp24_loadImage(argv[1]);
+    if (!src) return 1;
+
+    double megapixels = (double)src->width * src->height / 1e6;
+    int failures = 0;
+
+    printf("%dx%d, %d iterations\n", src->width, src->height, iterations);
+    printf("%-18s %14s %14s %14s %8s\n", "filter", "interleaved", "planar", "bgra", "same");
+
+    for (int f = 0; f < BENCH_COUNT; f++) {
+        t_bmp24 *inter, *planar, *bgra;
+        t_bmp8 *inter8, *planar8, *bgra8;
+        double ti = timeFilter(src, BMP24_INTERLEAVED, (t_bench_filter)f, iterations, &inter, &inter8);
+        double tp = timeFilter(src, BMP24_PLANAR, (t_bench_filter)f, iterations, &planar, &planar8);
+        double tb = timeFilter(src, BMP24_BGRA, (t_bench_filter)f, iterations, &bgra, &bgra8);
+        if (ti < 0 || tp < 0 || tb < 0) {
+            fprintf(stderr, "Error: %s failed\n", benchNames[f]);
+            failures++;
+        } else {
+            int same = sameResult(inter, planar, inter8, planar8) && sameResult(inter, bgra, inter8, bgra8);
+            if (!same) failures++;
+            printf("%-18s %9.1f MP/s %9.1f MP/s %9.1f MP/s %8s\n", benchNames[f],
+                   megapixels / ti, megapixels / tp, megapixels / tb, same ? "yes" : "NO");
+        }
+        bmp24_free(inter);
+        bmp24_free(planar);
+        bmp24_free(bgra);
+        if (inter8) bmp8_free(inter8);
+        if (planar8) bmp8_free(planar8);
+        if (bgra8) bmp8_free(bgra8);
+    }
+
+    if (benchChain(src, iterations) != 0) failures++;
+    failures += benchResize(src, iterations);
+
+    bmp24_free(src);
+    return failures ? 1 : 0;
+}
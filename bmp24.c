@@ -1,6 +1,10 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "bmp24.h"
+#include "probe.h"
+#include "image.h"
+#include "resize.h"
 #include <math.h>
 
 
@@ -53,6 +57,49 @@ void bmp24_freeDataPixels(t_pixel **pixels, int height) {
 
 
 
+/// @brief Allocates the three planes of a planar image in a single block. Every row is padded to a
+/// multiple of 32 bytes and every plane starts on a 32-byte boundary, so rows can be loaded with
+/// aligned vector instructions.
+/// @param img Image whose width and height are set.
+/// @return 0 on success, -1 if memory allocation fails.
+static int allocatePlanes(t_bmp24 *img) {
+    img->planeStride = (img->width + 31) & ~31;
+    size_t planeSize = (size_t)img->planeStride * img->height;
+
+    img->planeBuffer = (uint8_t *)malloc(3 * planeSize + 31);
+    if (!img->planeBuffer) {
+        fprintf(stderr, "Memory allocation failed for pixel planes.\n");
+        return -1;
+    }
+
+    uint8_t *base = (uint8_t *)(((uintptr_t)img->planeBuffer + 31) & ~(uintptr_t)31);
+    for (int c = 0; c < 3; c++) {
+        img->planes[c] = base + c * planeSize;
+    }
+    return 0;
+}
+
+
+/// @brief Allocates the rows of a BGRA image in a single block, every row padded to a multiple of
+/// 32 bytes and starting on a 32-byte boundary. All pixels start fully opaque.
+/// @param img Image whose width and height are set.
+/// @return 0 on success, -1 if memory allocation fails.
+static int allocateBgra(t_bmp24 *img) {
+    img->bgraStride = (img->width * 4 + 31) & ~31;
+    size_t size = (size_t)img->bgraStride * img->height;
+
+    img->planeBuffer = (uint8_t *)malloc(size + 31);
+    if (!img->planeBuffer) {
+        fprintf(stderr, "Memory allocation failed for BGRA pixels.\n");
+        return -1;
+    }
+
+    img->bgra = (uint8_t *)(((uintptr_t)img->planeBuffer + 31) & ~(uintptr_t)31);
+    memset(img->bgra, 255, size);
+    return 0;
+}
+
+
 /// @brief fThis function allocates memory for a t_bmp24 structure and its associated pixel data. It initializes
 /// the width, height, and colorDepth fields, and allocates memory for the pixel data using bmp24_allocateDataPixels.
 /// If any allocation fails, it returns NULL.
@@ -63,8 +110,31 @@ void bmp24_freeDataPixels(t_pixel **pixels, int height) {
 /// @return A pointer to the allocated t_bmp24 structure on success, or NULL if memory allocation fails.
 
 
+/// @brief Allocates the pixels of an image for its layout.
+/// @param img Image whose width, height and layout are set.
+/// @return 0 on success, -1 if memory allocation fails.
+static int allocateStorage(t_bmp24 *img) {
+    if (img->layout == BMP24_PLANAR) return allocatePlanes(img);
+    if (img->layout == BMP24_BGRA) return allocateBgra(img);
+
+    img->data = bmp24_allocateDataPixels(img->width, img->height);
+    return img->data ? 0 : -1;
+}
+
+
 t_bmp24 *bmp24_allocate(int width, int height, int colorDepth) {
-    t_bmp24 *img = (t_bmp24 *)malloc(sizeof(t_bmp24));
+    return bmp24_allocateLayout(width, height, colorDepth, BMP24_INTERLEAVED);
+}
+
+
+/// @brief Same as bmp24_allocate, with the choice of the memory layout of the pixels.
+/// @param width The width of the image in pixels.
+/// @param height The height of the image in pixels.
+/// @param colorDepth The color depth of the image.
+/// @param layout BMP24_INTERLEAVED (t_pixel rows), BMP24_PLANAR (one plane per channel) or BMP24_BGRA (4 bytes per pixel).
+/// @return A pointer to the allocated t_bmp24 structure on success, or NULL if memory allocation fails.
+t_bmp24 *bmp24_allocateLayout(int width, int height, int colorDepth, t_bmp24_layout layout) {
+    t_bmp24 *img = (t_bmp24 *)calloc(1, sizeof(t_bmp24));
     if (!img) {
         fprintf(stderr, "Memory allocation failed for image.\n");
         return NULL;
@@ -73,13 +143,12 @@ t_bmp24 *bmp24_allocate(int width, int height, int colorDepth) {
     img->width = width;
     img->height = height;
     img->colorDepth = colorDepth;
-    img->data = bmp24_allocateDataPixels(width, height);
+    img->layout = layout;
 
-    if (!img->data) {
+    if (allocateStorage(img) != 0) {
         free(img);
         return NULL;
     }
-
     return img;
 }
 
@@ -88,48 +157,313 @@ t_bmp24 *bmp24_allocate(int width, int height, int colorDepth) {
 void bmp24_free(t_bmp24 *img) {
     if (!img) return;
     bmp24_freeDataPixels(img->data, img->height);
+    free(img->planeBuffer);
     free(img);
 }
 
 
 
-/// @brief Loads a 24-bit BMP image from file into memory.
-/// @param filename Path to the BMP file to load.
-/// @return Pointer to loaded image structure, or NULL if loading fails.
-t_bmp24 *bmp24_loadImage(const char *filename) {
-    FILE *file = fopen(filename, "rb");
-    if (!file) {
-        fprintf(stderr, "Error opening file %s\n", filename);
-        return NULL;
+/// @brief Duplicates an image (headers and pixels, same layout), e.g. to run a filter without modifying the original.
+/// @param img Image to copy.
+/// @return Pointer to the copy, or NULL if memory allocation fails.
+t_bmp24 *bmp24_copy(t_bmp24 *img) {
+    if (!img || (!img->data && !img->planes[0] && !img->bgra)) return NULL;
+
+    t_bmp24 *copy = bmp24_allocateLayout(img->width, img->height, img->colorDepth, img->layout);
+    if (!copy) return NULL;
+
+    copy->header = img->header;
+    copy->header_info = img->header_info;
+    copy->topDown = img->topDown;
+    if (img->layout == BMP24_PLANAR) {
+        for (int c = 0; c < 3; c++) {
+            memcpy(copy->planes[c], img->planes[c], (size_t)img->planeStride * img->height);
+        }
+    } else if (img->layout == BMP24_BGRA) {
+        // Row by row : an image aliasing a memory buffer has the stride of the file
+        for (int y = 0; y < img->height; y++) {
+            memcpy(copy->bgra + (size_t)y * copy->bgraStride, img->bgra + (size_t)y * img->bgraStride, (size_t)img->width * 4);
+        }
+    } else {
+        for (int y = 0; y < img->height; y++) {
+            memcpy(copy->data[y], img->data[y], img->width * sizeof(t_pixel));
+        }
     }
+    return copy;
+}
 
-    t_bmp24 *img = (t_bmp24 *)malloc(sizeof(t_bmp24));
-    if (!img) {
-        fclose(file);
-        fprintf(stderr, "Memory allocation failed for image.\n");
-        return NULL;
+
+
+// Row conversions between the BGR order of the files, t_pixel rows and planes. They are plain
+// element-wise loops that the compiler vectorizes (with byte shuffles for the 3-byte stride).
+
+/// @brief Converts a row of BGR file bytes into t_pixel.
+static void bgrToPixels(const uint8_t *bgr, t_pixel *row, int width) {
+    for (int x = 0; x < width; x++) {
+        row[x].blue = bgr[3 * x];
+        row[x].green = bgr[3 * x + 1];
+        row[x].red = bgr[3 * x + 2];
+    }
+}
+
+/// @brief Converts a row of t_pixel into BGR file bytes.
+static void pixelsToBgr(const t_pixel *row, uint8_t *bgr, int width) {
+    for (int x = 0; x < width; x++) {
+        bgr[3 * x] = row[x].blue;
+        bgr[3 * x + 1] = row[x].green;
+        bgr[3 * x + 2] = row[x].red;
+    }
+}
+
+/// @brief Splits a row of BGR file bytes into the red, green and blue planes.
+static void bgrToPlanes(const uint8_t *bgr, uint8_t *red, uint8_t *green, uint8_t *blue, int width) {
+    for (int x = 0; x < width; x++) {
+        blue[x] = bgr[3 * x];
+        green[x] = bgr[3 * x + 1];
+        red[x] = bgr[3 * x + 2];
+    }
+}
+
+/// @brief Merges a row of the red, green and blue planes into BGR file bytes.
+static void planesToBgr(const uint8_t *red, const uint8_t *green, const uint8_t *blue, uint8_t *bgr, int width) {
+    for (int x = 0; x < width; x++) {
+        bgr[3 * x] = blue[x];
+        bgr[3 * x + 1] = green[x];
+        bgr[3 * x + 2] = red[x];
+    }
+}
+
+
+/// @brief Expands a row of BGR file bytes into opaque BGRA pixels.
+static void bgrToBgra(const uint8_t *bgr, uint8_t *bgra, int width) {
+    for (int x = 0; x < width; x++) {
+        bgra[4 * x] = bgr[3 * x];
+        bgra[4 * x + 1] = bgr[3 * x + 1];
+        bgra[4 * x + 2] = bgr[3 * x + 2];
+        bgra[4 * x + 3] = 255;
+    }
+}
+
+/// @brief Drops the alpha channel of a row of BGRA pixels.
+static void bgraToBgr(const uint8_t *bgra, uint8_t *bgr, int width) {
+    for (int x = 0; x < width; x++) {
+        bgr[3 * x] = bgra[4 * x];
+        bgr[3 * x + 1] = bgra[4 * x + 1];
+        bgr[3 * x + 2] = bgra[4 * x + 2];
+    }
+}
+
+
+/// @brief Writes row y of an image, whatever its layout, as BGR file bytes.
+static void rowToBgr(t_bmp24 *img, int y, uint8_t *bgr) {
+    if (img->layout == BMP24_PLANAR) {
+        size_t row = (size_t)y * img->planeStride;
+        planesToBgr(img->planes[0] + row, img->planes[1] + row, img->planes[2] + row, bgr, img->width);
+    } else if (img->layout == BMP24_BGRA) {
+        bgraToBgr(img->bgra + (size_t)y * img->bgraStride, bgr, img->width);
+    } else {
+        pixelsToBgr(img->data[y], bgr, img->width);
+    }
+}
+
+/// @brief Sets row y of an image, whatever its layout, from BGR file bytes (BGRA pixels become opaque).
+static void rowFromBgr(t_bmp24 *img, int y, const uint8_t *bgr) {
+    if (img->layout == BMP24_PLANAR) {
+        size_t row = (size_t)y * img->planeStride;
+        bgrToPlanes(bgr, img->planes[0] + row, img->planes[1] + row, img->planes[2] + row, img->width);
+    } else if (img->layout == BMP24_BGRA) {
+        bgrToBgra(bgr, img->bgra + (size_t)y * img->bgraStride, img->width);
+    } else {
+        bgrToPixels(bgr, img->data[y], img->width);
+    }
+}
+
+
+/// @brief Converts the pixels of an image to another memory layout. Converting to BMP24_BGRA makes
+/// every pixel opaque, converting from it drops the alpha channel.
+/// @param img Image to convert.
+/// @param layout BMP24_INTERLEAVED, BMP24_PLANAR or BMP24_BGRA.
+/// @return 0 on success, -1 if memory allocation fails (the image is left unchanged).
+int bmp24_setLayout(t_bmp24 *img, t_bmp24_layout layout) {
+    if (!img) return -1;
+    if (img->layout == layout) return 0;
+
+    t_bmp24 *converted = bmp24_allocateLayout(img->width, img->height, img->colorDepth, layout);
+    uint8_t *bgr = (uint8_t *)malloc((size_t)img->width * 3);
+    if (!converted || !bgr) {
+        fprintf(stderr, "Memory allocation failed for layout conversion.\n");
+        bmp24_free(converted);
+        free(bgr);
+        return -1;
+    }
+
+    for (int y = 0; y < img->height; y++) {
+        rowToBgr(img, y, bgr);
+        rowFromBgr(converted, y, bgr);
+    }
+    free(bgr);
+
+    // Swap the pixel storage, then release the old one with the temporary structure
+    t_bmp24 old = *img;
+    img->layout = converted->layout;
+    img->data = converted->data;
+    img->planeBuffer = converted->planeBuffer;
+    img->planeStride = converted->planeStride;
+    img->bgra = converted->bgra;
+    img->bgraStride = converted->bgraStride;
+    for (int c = 0; c < 3; c++) {
+        img->planes[c] = converted->planes[c];
+    }
+
+    converted->data = old.data;
+    converted->planeBuffer = old.planeBuffer;
+    bmp24_free(converted);
+    return 0;
+}
+
+
+/// @brief Reads one pixel, whatever the layout of the image.
+/// @param img Image to read.
+/// @param x @param y Coordinates of the pixel (row 0 is the top of the image).
+/// @return The pixel.
+t_pixel bmp24_getPixel(t_bmp24 *img, int x, int y) {
+    if (img->layout == BMP24_PLANAR) {
+        size_t i = (size_t)y * img->planeStride + x;
+        t_pixel p = {img->planes[0][i], img->planes[1][i], img->planes[2][i]};
+        return p;
+    }
+    if (img->layout == BMP24_BGRA) {
+        const uint8_t *q = img->bgra + (size_t)y * img->bgraStride + 4 * x;
+        t_pixel p = {q[2], q[1], q[0]};
+        return p;
+    }
+    return img->data[y][x];
+}
+
+
+/// @brief Writes one pixel, whatever the layout of the image.
+/// @param img Image to modify.
+/// @param x @param y Coordinates of the pixel (row 0 is the top of the image).
+/// @param p New value of the pixel.
+void bmp24_setPixel(t_bmp24 *img, int x, int y, t_pixel p) {
+    if (img->layout == BMP24_PLANAR) {
+        size_t i = (size_t)y * img->planeStride + x;
+        img->planes[0][i] = p.red;
+        img->planes[1][i] = p.green;
+        img->planes[2][i] = p.blue;
+        return;
+    }
+    if (img->layout == BMP24_BGRA) {
+        uint8_t *q = img->bgra + (size_t)y * img->bgraStride + 4 * x;
+        q[0] = p.blue;
+        q[1] = p.green;
+        q[2] = p.red;
+        return;
+    }
+    img->data[y][x] = p;
+}
+
+
+
+// Compression values of the info header used by 32-bit files
+#define BMP_BI_RGB 0
+#define BMP_BI_BITFIELDS 3
+#define BMP_BI_ALPHABITFIELDS 6
+
+// Bytes after the 40-byte info header that may hold the red, green, blue and alpha masks
+#define BMP_MASKS_SIZE 16
+
+// How one channel is stored in a 32-bit pixel : (pixel & mask) >> shift, on bits bits
+typedef struct {
+    uint32_t mask;
+    int shift;
+    int bits;
+} t_channel_mask;
+
+
+/// @brief Finds the position and width of a channel mask.
+static t_channel_mask channelMask(uint32_t mask) {
+    t_channel_mask m = {mask, 0, 0};
+    if (!mask) return m;
+    while (!((mask >> m.shift) & 1)) m.shift++;
+    while (m.shift + m.bits < 32 && ((mask >> (m.shift + m.bits)) & 1)) m.bits++;
+    return m;
+}
+
+
+/// @brief Extracts a channel of a 32-bit pixel, scaled to 8 bits.
+static uint8_t maskedValue(uint32_t pixel, const t_channel_mask *m) {
+    uint32_t v = (pixel & m->mask) >> m->shift;
+    if (m->bits >= 8) return (uint8_t)(v >> (m->bits - 8));
+    return (uint8_t)(v * 255 / ((1u << m->bits) - 1));
+}
+
+
+/// @brief Converts a row of 32-bit file pixels into BGRA bytes. The usual masks (8 bits per channel,
+/// blue first) are a plain copy, any other masks are decoded pixel by pixel.
+/// @param src Row of the file.
+/// @param bgra Output row.
+/// @param width Width in pixels.
+/// @param masks Red, green, blue and alpha masks (a zero alpha mask makes the pixels opaque).
+static void decodeRow32(const uint8_t *src, uint8_t *bgra, int width, const t_channel_mask masks[4]) {
+    if (masks[0].mask == 0x00FF0000 && masks[1].mask == 0x0000FF00 && masks[2].mask == 0x000000FF) {
+        memcpy(bgra, src, (size_t)width * 4);
+        if (masks[3].mask != 0xFF000000) {
+            for (int x = 0; x < width; x++) bgra[4 * x + 3] = 255;
+        }
+        return;
     }
 
-    // Read the BMP file header
-    fread(&img->header.type, sizeof(uint16_t), 1, file);
-    fread(&img->header.size, sizeof(uint32_t), 1, file);
-    fread(&img->header.reserved1, sizeof(uint16_t), 1, file);
-    fread(&img->header.reserved2, sizeof(uint16_t), 1, file);
-    fread(&img->header.offset, sizeof(uint32_t), 1, file);
-
-    // Read the BMP info header
-    fread(&img->header_info.size, sizeof(uint32_t), 1, file);
-    fread(&img->header_info.width, sizeof(int32_t), 1, file);
-    fread(&img->header_info.height, sizeof(int32_t), 1, file);
-    fread(&img->header_info.planes, sizeof(uint16_t), 1, file);
-    fread(&img->header_info.bits, sizeof(uint16_t), 1, file);
-    fread(&img->header_info.compression, sizeof(uint32_t), 1, file);
-    fread(&img->header_info.imagesize, sizeof(uint32_t), 1, file);
-    fread(&img->header_info.xresolution, sizeof(int32_t), 1, file);
-    fread(&img->header_info.yresolution, sizeof(int32_t), 1, file);
-    fread(&img->header_info.ncolors, sizeof(uint32_t), 1, file);
-    fread(&img->header_info.importantcolors, sizeof(uint32_t), 1, file);
+    for (int x = 0; x < width; x++) {
+        uint32_t pixel = src[4 * x] | (src[4 * x + 1] << 8) | (src[4 * x + 2] << 16) | ((uint32_t)src[4 * x + 3] << 24);
+        bgra[4 * x] = maskedValue(pixel, &masks[2]);
+        bgra[4 * x + 1] = maskedValue(pixel, &masks[1]);
+        bgra[4 * x + 2] = maskedValue(pixel, &masks[0]);
+        bgra[4 * x + 3] = masks[3].mask ? maskedValue(pixel, &masks[3]) : 255;
+    }
+}
+
+
+/// @brief Reads the channel masks of a 32-bit file. BI_RGB files use the fixed 8-bit layout with
+/// the fourth byte as alpha, BI_BITFIELDS files store the masks right after the 40-byte info header.
+/// @param bytes @param count Bytes of the file that follow the 40-byte info header (up to BMP_MASKS_SIZE).
+/// @return 0 on success, -1 if the compression is not supported.
+static int readMasks32(const uint8_t *bytes, size_t count, const t_bmp_info *info, t_channel_mask masks[4]) {
+    uint32_t raw[4] = {0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000};
+
+    if (info->compression == BMP_BI_BITFIELDS || info->compression == BMP_BI_ALPHABITFIELDS) {
+        // V3 and later headers (56 bytes and more) always have room for the alpha mask
+        int maskCount = (info->compression == BMP_BI_ALPHABITFIELDS || info->size >= 56) ? 4 : 3;
+        raw[3] = 0;
+        if (count < maskCount * sizeof(uint32_t)) return -1;
+        memcpy(raw, bytes, maskCount * sizeof(uint32_t));
+    } else if (info->compression != BMP_BI_RGB) {
+        return -1;
+    }
 
+    for (int c = 0; c < 4; c++) {
+        masks[c] = channelMask(raw[c]);
+    }
+    return 0;
+}
+
+
+/// @brief Reads the bytes that follow the 40-byte info header, where BI_BITFIELDS files keep their masks.
+/// @param file The open file.
+/// @param bytes Receives up to BMP_MASKS_SIZE bytes.
+/// @return The number of bytes read.
+static size_t readMaskBytes(FILE *file, uint8_t bytes[BMP_MASKS_SIZE]) {
+    if (fseek(file, BMP_HEADER_SIZE, SEEK_SET) != 0) return 0;
+    return fread(bytes, 1, BMP_MASKS_SIZE, file);
+}
+
+
+/// @brief Checks the headers of a 24-bit or 32-bit BMP file, and sets the size and orientation of the image.
+/// @param maskBytes @param maskCount Bytes that follow the info header, only read for the channel masks of 32-bit files.
+/// @param img Image whose header and header_info are filled.
+/// @param masks Receives the channel masks of 32-bit files.
+/// @return 0 on success, -1 if the file is not a supported BMP file.
+static int checkHeaders(const uint8_t *maskBytes, size_t maskCount, t_bmp24 *img, t_channel_mask masks[4]) {
     // Debug: Print header information
     printf("File header type: 0x%X\n", img->header.type);
     printf("File header size: %u\n", img->header.size);
@@ -138,143 +472,654 @@ t_bmp24 *bmp24_loadImage(const char *filename) {
     printf("Image height: %d\n", img->header_info.height);
     printf("Bits per pixel: %u\n", img->header_info.bits);
 
-    // Check if the file is a valid 24-bit BMP file
-    if (img->header.type != 0x4D42 || img->header_info.bits != 24) {
-        fprintf(stderr, "Error: Not a 24-bit BMP file.\n");
-        free(img);
-        fclose(file);
-        return NULL;
+    // Check if the file is a valid 24-bit or 32-bit BMP file
+    int bits = img->header_info.bits;
+    if (img->header.type != 0x4D42 || (bits != 24 && bits != 32)) {
+        fprintf(stderr, "Error: Not a 24-bit or 32-bit BMP file.\n");
+        return -1;
+    }
+
+    if ((bits == 24 && img->header_info.compression != BMP_BI_RGB) ||
+        (bits == 32 && readMasks32(maskBytes, maskCount, &img->header_info, masks) != 0)) {
+        fprintf(stderr, "Error: Unsupported BMP compression %u.\n", img->header_info.compression);
+        return -1;
     }
 
     img->width = img->header_info.width;
     img->height = abs(img->header_info.height); // Handle negative heights
-    img->colorDepth = img->header_info.bits;
-    img->data = bmp24_allocateDataPixels(img->width, img->height);
+    img->topDown = img->header_info.height < 0;
+    img->colorDepth = bits;
+    return 0;
+}
 
-    if (!img->data) {
+
+/// @brief Reads and checks the headers of a 24-bit or 32-bit BMP file, and sets the size and orientation of the image.
+/// @param file File positioned at its start.
+/// @param img Image receiving the headers.
+/// @param masks Receives the channel masks of 32-bit files.
+/// @return 0 on success, -1 if the file is not a supported BMP file.
+static int readHeaders(FILE *file, t_bmp24 *img, t_channel_mask masks[4]) {
+    unsigned char raw[BMP_HEADER_SIZE];
+    uint8_t maskBytes[BMP_MASKS_SIZE];
+    if (bmp_readHeader(file, raw, &img->header, &img->header_info) != 0) return -1;
+    size_t maskCount = readMaskBytes(file, maskBytes);
+    return checkHeaders(maskBytes, maskCount, img, masks);
+}
+
+
+/// @brief Gives the number of rows moved by each read or write of the pixels, so that they move in strips
+/// of about BMP_IO_STRIP bytes.
+/// @param rowSize Bytes of a row in the file.
+/// @param height Rows of the image.
+/// @return At least 1, at most height (unless height is 0).
+static int stripRows(int rowSize, int height) {
+    int rows = BMP_IO_STRIP / rowSize;
+    if (rows < 1) rows = 1;
+    return (height > 0 && rows > height) ? height : rows;
+}
+
+
+/// @brief Converts a row read from a 24-bit or 32-bit file into row y of an image.
+/// @param img Image to fill.
+/// @param y Row of the image (0 is the top).
+/// @param fileRow Pixels as stored in the file.
+/// @param masks Channel masks of 32-bit files.
+/// @param bgr Scratch buffer of 4 bytes per pixel.
+static void storeFileRow(t_bmp24 *img, int y, const uint8_t *fileRow, const t_channel_mask masks[4], uint8_t *bgr) {
+    if (img->colorDepth == 24) {
+        rowFromBgr(img, y, fileRow);
+    } else if (img->layout == BMP24_BGRA) {
+        decodeRow32(fileRow, img->bgra + (size_t)y * img->bgraStride, img->width, masks);
+    } else {
+        decodeRow32(fileRow, bgr, img->width, masks);
+        bgraToBgr(bgr, bgr, img->width);
+        rowFromBgr(img, y, bgr);
+    }
+}
+
+
+/// @brief Makes the pixels of a BI_RGB 32-bit image opaque when its fourth bytes are all zero : many
+/// writers leave them at zero, such an image is opaque, not invisible.
+static void fixZeroAlpha(t_bmp24 *img) {
+    if (img->colorDepth != 32 || img->layout != BMP24_BGRA || img->header_info.compression != BMP_BI_RGB) return;
+
+    for (int y = 0; y < img->height; y++) {
+        const uint8_t *row = img->bgra + (size_t)y * img->bgraStride;
+        for (int x = 0; x < img->width; x++) {
+            if (row[4 * x + 3]) return;
+        }
+    }
+    for (int y = 0; y < img->height; y++) {
+        uint8_t *row = img->bgra + (size_t)y * img->bgraStride;
+        for (int x = 0; x < img->width; x++) row[4 * x + 3] = 255;
+    }
+}
+
+
+/// @brief Reads and checks the headers of an open 24-bit or 32-bit BMP file, unless they come from a probe.
+/// @param file The file, positioned at its start when there is no probe. It is left open.
+/// @param probe Headers already read by bmp_probe, or NULL.
+/// @param masks Receives the channel masks of 32-bit files.
+/// @return An image holding the headers, size and orientation, without pixels, or NULL on error.
+static t_bmp24 *readImageHeaders(FILE *file, const t_bmp_probe *probe, t_channel_mask masks[4]) {
+    t_bmp24 *img = (t_bmp24 *)calloc(1, sizeof(t_bmp24));
+    if (!img) {
+        fprintf(stderr, "Memory allocation failed for image.\n");
+        return NULL;
+    }
+
+    int status;
+    if (probe) {
+        uint8_t maskBytes[BMP_MASKS_SIZE];
+        img->header = probe->header;
+        img->header_info = probe->info;
+        size_t maskCount = readMaskBytes(file, maskBytes);
+        status = checkHeaders(maskBytes, maskCount, img, masks);
+    } else {
+        status = readHeaders(file, img, masks);
+    }
+    if (status != 0) {
         free(img);
-        fclose(file);
         return NULL;
     }
+    return img;
+}
+
+
+/// @brief Reads the pixel rows of an open file in file order, with a single seek. Each row is either
+/// converted into the image, or decoded to BGRA and added to a box average (thumbnails), so that only
+/// one file row is in memory at a time.
+/// @param file The open file.
+/// @param img Image holding the headers, and the pixels unless box is given.
+/// @param masks Channel masks of 32-bit files.
+/// @param box Box average receiving the rows instead of the image, or NULL.
+/// @return 0 on success, -1 on error.
+static int readPixelRows(FILE *file, t_bmp24 *img, const t_channel_mask masks[4], t_resize_box *box) {
+    // Row i of a bottom-up file is image row height - 1 - i : it is converted straight into that row,
+    // so no flip copy is needed.
+    // The rows are read by strips of several rows, then converted one by one.
+    int bytesPerPixel = img->colorDepth / 8;
+    int rowSize = (img->width * bytesPerPixel + 3) & ~3;
+    int strip = stripRows(rowSize, img->height);
+    uint8_t *fileRows = (uint8_t *)malloc((size_t)strip * rowSize);
+    uint8_t *bgr = (uint8_t *)malloc((size_t)img->width * 4);
+    if (!fileRows || !bgr) {
+        fprintf(stderr, "Memory allocation failed for pixel rows.\n");
+        free(fileRows);
+        free(bgr);
+        return -1;
+    }
 
-    // Move file pointer to the start of pixel data
+    int status = 0;
     fseek(file, img->header.offset, SEEK_SET);
+    for (int i0 = 0; i0 < img->height && status == 0; i0 += strip) {
+        int count = img->height - i0 < strip ? img->height - i0 : strip;
+
+        // The padding of the last row may be missing in some files
+        size_t needed = (size_t)(count - 1) * rowSize + (size_t)img->width * bytesPerPixel;
+        if (fread(fileRows, 1, (size_t)count * rowSize, file) < needed) {
+            fprintf(stderr, "Error reading pixel data.\n");
+            status = -1;
+            break;
+        }
 
-    // Read pixel data (BMP files store pixels bottom-up, so we need to flip)
-    int padding = (4 - (img->width * 3) % 4) % 4;
-    for (int y = 0; y < img->height; y++) {
-        // Calculate the actual row in the BMP file (bottom-up storage)
-        int bmp_row = img->height - 1 - y;
-        fseek(file, img->header.offset + bmp_row * (img->width * 3 + padding), SEEK_SET);
-        
-        for (int x = 0; x < img->width; x++) {
-            uint8_t bgr[3];
-            if (fread(bgr, sizeof(uint8_t), 3, file) != 3) {
-                fprintf(stderr, "Error reading pixel data.\n");
-                bmp24_free(img);
-                fclose(file);
-                return NULL;
+        for (int k = 0; k < count; k++) {
+            int i = i0 + k;
+            int y = img->topDown ? i : img->height - 1 - i;
+            const uint8_t *fileRow = fileRows + (size_t)k * rowSize;
+            if (!box) {
+                storeFileRow(img, y, fileRow, masks, bgr);
+            } else {
+                if (img->colorDepth == 24) bgrToBgra(fileRow, bgr, img->width);
+                else decodeRow32(fileRow, bgr, img->width, masks);
+                resize_boxAddRow(box, y, bgr);
             }
-            img->data[y][x].blue = bgr[0];
-            img->data[y][x].green = bgr[1];
-            img->data[y][x].red = bgr[2];
         }
     }
 
+    free(fileRows);
+    free(bgr);
+    return status;
+}
+
+
+/// @brief Reads the headers (unless they come from a probe) and the pixels of an open 24-bit or 32-bit BMP file.
+/// @param file The file, positioned at its start when there is no probe. It is left open.
+/// @param probe Headers already read by bmp_probe, or NULL.
+/// @param layout Layout of the loaded image.
+/// @param keepAlpha Non-zero to load 32-bit files in BMP24_BGRA whatever the requested layout.
+/// @return Pointer to loaded image structure, or NULL if loading fails.
+static t_bmp24 *loadPixels(FILE *file, const t_bmp_probe *probe, t_bmp24_layout layout, int keepAlpha) {
+    t_channel_mask masks[4];
+    t_bmp24 *img = readImageHeaders(file, probe, masks);
+    if (!img) return NULL;
+
+    img->layout = (img->colorDepth == 32 && keepAlpha) ? BMP24_BGRA : layout;
+    if (allocateStorage(img) != 0) {
+        free(img);
+        return NULL;
+    }
+    if (readPixelRows(file, img, masks, NULL) != 0) {
+        bmp24_free(img);
+        return NULL;
+    }
+
+    fixZeroAlpha(img);
+    return img;
+}
+
+
+/// @brief Reads the headers and the pixels of a 24-bit or 32-bit BMP file.
+/// @param filename Path to the BMP file to load.
+/// @param layout Layout of the loaded image.
+/// @param keepAlpha Non-zero to load 32-bit files in BMP24_BGRA whatever the requested layout.
+/// @return Pointer to loaded image structure, or NULL if loading fails.
+static t_bmp24 *loadImage(const char *filename, t_bmp24_layout layout, int keepAlpha) {
+    FILE *file = fopen(filename, "rb");
+    if (!file) {
+        fprintf(stderr, "Error opening file %s\n", filename);
+        return NULL;
+    }
+    t_bmp24 *img = loadPixels(file, NULL, layout, keepAlpha);
     fclose(file);
     return img;
 }
 
-/// @brief Applies a convolution filter to the entire image using given kernel.
-/// @param img Image to apply filter to.
-/// @param kernel Filter kernel values as 1D array.
-/// @param kernelSize Size of the square kernel (e.g., 3 for 3x3).
-void bmp24_applyFilter(t_bmp24 *img, float *kernel, int kernelSize) {
-    if (!img || !img->data || !kernel) return;
 
-    t_pixel **newData = malloc(img->height * sizeof(t_pixel *));
-    for (int y = 0; y < img->height; y++) {
-        newData[y] = malloc(img->width * sizeof(t_pixel));
+/// @brief Loads the 24-bit or 32-bit image of a probed file, reusing its open file and its headers.
+/// The layout is the one of bmp24_loadImage. The file of the probe is closed, whether loading succeeds or not.
+/// @param probe A probe filled by bmp_probe.
+/// @return Pointer to loaded image structure, or NULL if loading fails.
+t_bmp24 *bmp24_loadFromProbe(t_bmp_probe *probe) {
+    if (!probe || !probe->file) {
+        fprintf(stderr, "Error: The probe has no open file.\n");
+        return NULL;
     }
+    t_bmp24 *img = loadPixels(probe->file, probe, BMP24_INTERLEAVED, 1);
+    bmp_probeClose(probe);
+    return img;
+}
+
+
+/// @brief Tells whether the rows of a 32-bit file in memory can be used as they are by a BGRA image : they
+/// must be top-down (row 0 of the image first), in the usual B, G, R, A byte order, and must not need
+/// the zero-alpha fix of fixZeroAlpha.
+static int canAliasRows(const t_bmp24 *img, const t_channel_mask masks[4], const uint8_t *pixels, int rowSize) {
+    if (img->colorDepth != 32 || !img->topDown) return 0;
+    if (masks[0].mask != 0x00FF0000 || masks[1].mask != 0x0000FF00 ||
+        masks[2].mask != 0x000000FF || masks[3].mask != 0xFF000000) return 0;
+    if (img->header_info.compression != BMP_BI_RGB) return 1;
 
     for (int y = 0; y < img->height; y++) {
+        const uint8_t *row = pixels + (size_t)y * rowSize;
         for (int x = 0; x < img->width; x++) {
-            newData[y][x] = bmp24_convolution(img, x, y, kernel, kernelSize);
+            if (row[4 * x + 3]) return 1;
         }
     }
+    return 0;
+}
 
-    // Copy back
-    for (int y = 0; y < img->height; y++) {
-        for (int x = 0; x < img->width; x++) {
-            img->data[y][x] = newData[y][x];
+
+/// @brief Decodes a 24-bit or 32-bit BMP file held in memory, with the layouts of bmp24_loadImage.
+/// With alias set, a top-down 32-bit file whose rows are already BGRA is not copied : the image points
+/// into the buffer (bgra rows of the file stride, planeBuffer NULL), which must then outlive it, and the
+/// filters modify the buffer in place. Other files are always decoded into a copy.
+/// @param buffer The whole file.
+/// @param size Size of the file in bytes.
+/// @param alias Non-zero to point into the buffer when the layout allows it.
+/// @return Pointer to the image, or NULL if the buffer is not a supported (or is a truncated) BMP file.
+t_bmp24 *bmp24_loadFromMemory(unsigned char *buffer, size_t size, int alias) {
+    if (!buffer || size < BMP_HEADER_SIZE) {
+        fprintf(stderr, "Error reading BMP header\n");
+        return NULL;
+    }
+
+    t_bmp24 *img = (t_bmp24 *)calloc(1, sizeof(t_bmp24));
+    if (!img) {
+        fprintf(stderr, "Memory allocation failed for image.\n");
+        return NULL;
+    }
+
+    t_channel_mask masks[4];
+    size_t maskCount = size - BMP_HEADER_SIZE < BMP_MASKS_SIZE ? size - BMP_HEADER_SIZE : BMP_MASKS_SIZE;
+    if (bmp_parseHeader(buffer, &img->header, &img->header_info) != 0 ||
+        checkHeaders(buffer + BMP_HEADER_SIZE, maskCount, img, masks) != 0) {
+        free(img);
+        return NULL;
+    }
+
+    // The padding of the last row may be missing
+    int bytesPerPixel = img->colorDepth / 8;
+    int rowSize = (img->width * bytesPerPixel + 3) & ~3;
+    size_t offset = img->header.offset;
+    if (offset > size || size - offset < (size_t)rowSize * (img->height - 1) + (size_t)img->width * bytesPerPixel) {
+        fprintf(stderr, "Error reading pixel data.\n");
+        free(img);
+        return NULL;
+    }
+    uint8_t *pixels = buffer + offset;
+
+    if (alias && canAliasRows(img, masks, pixels, rowSize)) {
+        img->layout = BMP24_BGRA;
+        img->bgra = pixels;
+        img->bgraStride = rowSize;
+        return img;
+    }
+
+    img->layout = img->colorDepth == 32 ? BMP24_BGRA : BMP24_INTERLEAVED;
+    uint8_t *bgr = (uint8_t *)malloc((size_t)img->width * 4);
+    if (!bgr || allocateStorage(img) != 0) {
+        fprintf(stderr, "Memory allocation failed for pixel row.\n");
+        free(bgr);
+        bmp24_free(img);
+        return NULL;
+    }
+
+    for (int i = 0; i < img->height; i++) {
+        int y = img->topDown ? i : img->height - 1 - i;
+        storeFileRow(img, y, pixels + (size_t)i * rowSize, masks, bgr);
+    }
+
+    free(bgr);
+    fixZeroAlpha(img);
+    return img;
+}
+
+
+/// @brief Loads a 24-bit or 32-bit BMP image from file into memory. 24-bit files are loaded in the
+/// interleaved layout, 32-bit files in the BGRA layout so that their alpha channel is kept.
+/// @param filename Path to the BMP file to load.
+/// @return Pointer to loaded image structure, or NULL if loading fails.
+t_bmp24 *bmp24_loadImage(const char *filename) {
+    return loadImage(filename, BMP24_INTERLEAVED, 1);
+}
+
+
+/// @brief Loads a 24-bit or 32-bit BMP image, converting the file rows straight into the requested
+/// layout. Asking for BMP24_BGRA promotes 24-bit files to 4 bytes per pixel (opaque), asking for
+/// another layout drops the alpha channel of 32-bit files.
+/// @param filename Path to the BMP file to load.
+/// @param layout BMP24_INTERLEAVED, BMP24_PLANAR or BMP24_BGRA.
+/// @return Pointer to loaded image structure, or NULL if loading fails.
+t_bmp24 *bmp24_loadImageLayout(const char *filename, t_bmp24_layout layout) {
+    return loadImage(filename, layout, 0);
+}
+
+/// @brief Loads only a rectangle of a 24-bit or 32-bit BMP file. Uncompressed rows are directly addressable,
+/// so each row of the region is one seek and one read of exactly its bytes : the I/O is proportional to
+/// the area of the region, not to the size of the file.
+/// @param filename Path to the BMP file to load.
+/// @param x @param y Top-left corner of the region (row 0 is the top of the image).
+/// @param width @param height Size of the region, clipped to the image.
+/// @return The region as a new image (interleaved, or BGRA for 32-bit files), or NULL on error.
+t_bmp24 *bmp24_loadRegion(const char *filename, int x, int y, int width, int height) {
+    FILE *file = fopen(filename, "rb");
+    if (!file) {
+        fprintf(stderr, "Error opening file %s\n", filename);
+        return NULL;
+    }
+    // Unbuffered : every read fetches the bytes of one region row and nothing more
+    setvbuf(file, NULL, _IONBF, 0);
+
+    t_bmp24 *img = (t_bmp24 *)calloc(1, sizeof(t_bmp24));
+    if (!img) {
+        fclose(file);
+        fprintf(stderr, "Memory allocation failed for image.\n");
+        return NULL;
+    }
+
+    t_channel_mask masks[4];
+    if (readHeaders(file, img, masks) != 0) {
+        free(img);
+        fclose(file);
+        return NULL;
+    }
+
+    int fileHeight = img->height;
+    int x0 = x < 0 ? 0 : x, y0 = y < 0 ? 0 : y;
+    int x1 = x + width > img->width ? img->width : x + width;
+    int y1 = y + height > fileHeight ? fileHeight : y + height;
+    if (x1 <= x0 || y1 <= y0) {
+        fprintf(stderr, "Error: Region is outside of the image.\n");
+        free(img);
+        fclose(file);
+        return NULL;
+    }
+
+    int bytesPerPixel = img->colorDepth / 8;
+    long rowSize = ((long)img->width * bytesPerPixel + 3) & ~3L;
+    img->width = x1 - x0;
+    img->height = y1 - y0;
+    img->header_info.width = img->width;
+    img->header_info.height = img->topDown ? -img->height : img->height;
+    img->layout = img->colorDepth == 32 ? BMP24_BGRA : BMP24_INTERLEAVED;
+    if (allocateStorage(img) != 0) {
+        free(img);
+        fclose(file);
+        return NULL;
+    }
+
+    size_t regionBytes = (size_t)img->width * bytesPerPixel;
+    uint8_t *fileRow = (uint8_t *)malloc(regionBytes);
+    uint8_t *bgr = (uint8_t *)malloc((size_t)img->width * 4);
+    if (!fileRow || !bgr) {
+        fprintf(stderr, "Memory allocation failed for pixel row.\n");
+        free(fileRow);
+        free(bgr);
+        bmp24_free(img);
+        fclose(file);
+        return NULL;
+    }
+
+    // Rows of the region in file order : top-down files start at row y0, bottom-up files at row fileHeight - y1
+    int firstFileRow = img->topDown ? y0 : fileHeight - y1;
+    for (int i = 0; i < img->height; i++) {
+        int fileRowIndex = firstFileRow + i;
+        int imageRow = img->topDown ? fileRowIndex : fileHeight - 1 - fileRowIndex;
+
+        fseek(file, img->header.offset + fileRowIndex * rowSize + (long)x0 * bytesPerPixel, SEEK_SET);
+        if (fread(fileRow, 1, regionBytes, file) != regionBytes) {
+            fprintf(stderr, "Error reading pixel data.\n");
+            free(fileRow);
+            free(bgr);
+            bmp24_free(img);
+            fclose(file);
+            return NULL;
         }
-        free(newData[y]);
+        storeFileRow(img, imageRow - y0, fileRow, masks, bgr);
     }
-    free(newData);
+
+    free(fileRow);
+    free(bgr);
+    fclose(file);
+
+    fixZeroAlpha(img);
+    return img;
 }
 
+/// @brief Loads a 24-bit or 32-bit BMP file reduced to fit in maxWidth x maxHeight (aspect ratio kept, never
+/// enlarged). Each pixel is the average of the box of file pixels it covers, summed while the rows are
+/// read : besides the thumbnail, only one file row and one row of sums are in memory, whatever the file size.
+/// @param filename Path to the BMP file to load.
+/// @param maxWidth @param maxHeight Largest size of the thumbnail.
+/// @return The thumbnail (interleaved, or BGRA for 32-bit files), or NULL on error.
+t_bmp24 *bmp24_loadThumbnail(const char *filename, int maxWidth, int maxHeight) {
+    if (maxWidth < 1 || maxHeight < 1) return NULL;
+    FILE *file = fopen(filename, "rb");
+    if (!file) {
+        fprintf(stderr, "Error opening file %s\n", filename);
+        return NULL;
+    }
+    t_channel_mask masks[4];
+    t_bmp24 *source = readImageHeaders(file, NULL, masks);
+    if (!source) {
+        fclose(file);
+        return NULL;
+    }
 
-int bmp24_saveImage(const char *filename, t_bmp24 *img){
-    FILE *f = fopen(filename, "wb");
-    if (!f) {
-        printf("Error opening file: %s\n", filename);
-        return 1;  // ERREUR
+    // The rows are summed as BGRA whatever the depth of the file
+    int width, height;
+    resize_fitSize(source->width, source->height, maxWidth, maxHeight, &width, &height);
+    t_bmp24 *img = bmp24_allocateLayout(width, height, source->colorDepth, BMP24_BGRA);
+    int status = -1;
+    if (img) {
+        t_image view;
+        t_resize_box box;
+        img->header = source->header;
+        img->header_info = source->header_info;
+        img->topDown = source->topDown;
+        img->header_info.width = width;
+        img->header_info.height = img->topDown ? -height : height;
+        if (image_fromBmp24(img, &view) == 0) {
+            if (resize_boxBegin(&box, &view, source->width, source->height) == 0) {
+                status = readPixelRows(file, source, masks, &box);
+                resize_boxEnd(&box);
+            }
+            image_free(&view);
+        }
+    }
+    free(source);
+    fclose(file);
+
+    if (status == 0 && img->colorDepth == 24) status = bmp24_setLayout(img, BMP24_INTERLEAVED);
+    if (status != 0) {
+        bmp24_free(img);
+        return NULL;
+    }
+    fixZeroAlpha(img);
+    return img;
+}
+
+/// @brief Applies a convolution filter to the entire image using given kernel. Out-of-image samples are
+/// skipped, like in bmp24_convolution.
+/// @param img Image to apply filter to.
+/// @param kernel Filter kernel values as 1D array, kernel[(dx + n) * kernelSize + (dy + n)].
+/// @param kernelSize Size of the square kernel (e.g., 3 for 3x3).
+void bmp24_applyFilter(t_bmp24 *img, float *kernel, int kernelSize) {
+    if (!img || !kernel) return;
+
+    // The shared kernels read the kernel row by row from the top
+    float *rows = (float *)malloc((size_t)kernelSize * kernelSize * sizeof(float));
+    if (!rows) {
+        fprintf(stderr, "Memory allocation failed for filter.\n");
+        return;
     }
+    for (int i = 0; i < kernelSize; i++) {
+        for (int j = 0; j < kernelSize; j++) {
+            rows[j * kernelSize + i] = kernel[i * kernelSize + j];
+        }
+    }
+
+    t_image view;
+    if (image_fromBmp24(img, &view) == 0) {
+        image_convolve(&view, rows, kernelSize, 0, IMAGE_ROUND);
+        image_free(&view);
+    }
+    free(rows);
+}
+
+
+/// @brief Applies one of the preset 3x3 kernels, leaving the one pixel border unchanged.
+static void applyPreset(t_bmp24 *img, t_image_kernel kernel) {
+    t_image view;
+    if (image_fromBmp24(img, &view) != 0) return;
+    image_convolve(&view, image_presetKernel(kernel), 3, 1, IMAGE_ROUND);
+    image_free(&view);
+}
+
+
+/// @brief Writes a whole 24-bit or 32-bit BMP file (headers and pixels) to a writer.
+/// @param writer A file or a memory buffer.
+/// @param img Image to save.
+/// @return 0 on success, -1 on error.
+static int writeImage24(t_bmp_writer *writer, t_bmp24 *img) {
+    int withAlpha = (img->colorDepth == 32);
+    int rowSize = withAlpha ? img->width * 4 : (img->width * 3 + 3) & ~3;
 
     // Write BMP header (14 bytes)
     uint16_t type = 0x4D42;
-    uint32_t offset = 54;
-    uint32_t size = offset + (img->width * 3 + (4 - (img->width * 3 % 4)) % 4) * img->height;
+    uint32_t headerSize = withAlpha ? 108 : 40;
+    uint32_t offset = 14 + headerSize;
+    uint32_t size = offset + (uint32_t)rowSize * img->height;
     uint16_t reserved = 0;
 
-    fwrite(&type, sizeof(uint16_t), 1, f);
-    fwrite(&size, sizeof(uint32_t), 1, f);
-    fwrite(&reserved, sizeof(uint16_t), 1, f);
-    fwrite(&reserved, sizeof(uint16_t), 1, f);
-    fwrite(&offset, sizeof(uint32_t), 1, f);
+    bmp_write(writer, &type, sizeof(uint16_t));
+    bmp_write(writer, &size, sizeof(uint32_t));
+    bmp_write(writer, &reserved, sizeof(uint16_t));
+    bmp_write(writer, &reserved, sizeof(uint16_t));
+    bmp_write(writer, &offset, sizeof(uint32_t));
 
     // Info header (40 bytes)
-    uint32_t headerSize = 40;
     uint16_t planes = 1;
-    uint16_t bits = 24;
-    uint32_t compression = 0;
+    uint16_t bits = withAlpha ? 32 : 24;
+    uint32_t compression = withAlpha ? BMP_BI_BITFIELDS : BMP_BI_RGB;
+    uint32_t zero = 0;
     uint32_t imageSize = size - offset;
     int32_t resolution = 2835;
 
-    fwrite(&headerSize, sizeof(uint32_t), 1, f);
-    fwrite(&img->width, sizeof(int32_t), 1, f);
-    fwrite(&img->height, sizeof(int32_t), 1, f);
-    fwrite(&planes, sizeof(uint16_t), 1, f);
-    fwrite(&bits, sizeof(uint16_t), 1, f);
-    fwrite(&compression, sizeof(uint32_t), 1, f);
-    fwrite(&imageSize, sizeof(uint32_t), 1, f);
-    fwrite(&resolution, sizeof(int32_t), 1, f);
-    fwrite(&resolution, sizeof(int32_t), 1, f);
-    fwrite(&compression, sizeof(uint32_t), 1, f);
-    fwrite(&compression, sizeof(uint32_t), 1, f);
-
-    // Write pixels (BMP files store pixels bottom-up)
-    int padding = (4 - (img->width * 3) % 4) % 4;
-    unsigned char pad[3] = {0, 0, 0};
-
-    for (int y = img->height - 1; y >= 0; y--) {
-        for (int x = 0; x < img->width; x++) {
-            unsigned char bgr[3] = {
-                img->data[y][x].blue,
-                img->data[y][x].green,
-                img->data[y][x].red
-            };
-            fwrite(bgr, 1, 3, f);
+    bmp_write(writer, &headerSize, sizeof(uint32_t));
+    int32_t height = img->topDown ? -img->height : img->height;
+    bmp_write(writer, &img->width, sizeof(int32_t));
+    bmp_write(writer, &height, sizeof(int32_t));
+    bmp_write(writer, &planes, sizeof(uint16_t));
+    bmp_write(writer, &bits, sizeof(uint16_t));
+    bmp_write(writer, &compression, sizeof(uint32_t));
+    bmp_write(writer, &imageSize, sizeof(uint32_t));
+    bmp_write(writer, &resolution, sizeof(int32_t));
+    bmp_write(writer, &resolution, sizeof(int32_t));
+    bmp_write(writer, &zero, sizeof(uint32_t));
+    bmp_write(writer, &zero, sizeof(uint32_t));
+
+    // V4 part (68 bytes) : red, green, blue and alpha masks, sRGB color space, unused endpoints and gammas
+    if (withAlpha) {
+        uint32_t masks[4] = {0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000};
+        uint32_t colorSpace = 0x73524742; // 'sRGB'
+        uint8_t unused[48] = {0};
+        bmp_write(writer, masks, sizeof(uint32_t) * 4);
+        bmp_write(writer, &colorSpace, sizeof(uint32_t));
+        bmp_write(writer, unused, sizeof(unused));
+    }
+
+    // Write pixels in the orientation of the image (top-down files follow the memory order), by strips of
+    // whole rows (padding included, left at zero) per write
+    int strip = stripRows(rowSize, img->height);
+    uint8_t *fileRows = (uint8_t *)calloc((size_t)strip * rowSize, 1);
+    uint8_t *bgr = (uint8_t *)malloc((size_t)img->width * 3);
+    if (!fileRows || !bgr) {
+        printf("Memory allocation failed for pixel rows.\n");
+        free(fileRows);
+        free(bgr);
+        return -1;
+    }
+
+    for (int i0 = 0; i0 < img->height; i0 += strip) {
+        int count = img->height - i0 < strip ? img->height - i0 : strip;
+        for (int k = 0; k < count; k++) {
+            int y = img->topDown ? i0 + k : img->height - 1 - (i0 + k);
+            uint8_t *fileRow = fileRows + (size_t)k * rowSize;
+            if (withAlpha && img->layout == BMP24_BGRA) {
+                memcpy(fileRow, img->bgra + (size_t)y * img->bgraStride, rowSize);
+            } else if (withAlpha) {
+                // 32-bit image converted to a layout without alpha : the pixels are written opaque
+                rowToBgr(img, y, bgr);
+                bgrToBgra(bgr, fileRow, img->width);
+            } else {
+                rowToBgr(img, y, fileRow);
+            }
         }
-        fwrite(pad, 1, padding, f);
+        bmp_write(writer, fileRows, (size_t)count * rowSize);
     }
 
-    fclose(f);
+    free(fileRows);
+    free(bgr);
+    return writer->error ? -1 : 0;
+}
+
+
+/// @brief Saves an image as a 24-bit BMP file, or as a 32-bit one (BI_BITFIELDS with an alpha mask,
+/// BITMAPV4HEADER) when the image was loaded from a 32-bit file. Images promoted to BMP24_BGRA
+/// for processing are saved in 24 bits. The rows are written bottom-up, or top-down (negative
+/// height, same order as in memory) when img->topDown is set.
+/// @param filename Path of the file to write.
+/// @param img Image to save.
+/// @return 0 on success, 1 on error.
+int bmp24_saveImage(const char *filename, t_bmp24 *img){
+    FILE *f = fopen(filename, "wb");
+    if (!f) {
+        printf("Error opening file: %s\n", filename);
+        return 1;  // ERREUR
+    }
+    t_bmp_writer writer = {f, NULL, 0, 0};
+    int status = writeImage24(&writer, img);
+    if (fclose(f) != 0) status = -1;
+    if (status != 0) {
+        printf("Error writing file: %s\n", filename);
+        return 1;  // ERREUR
+    }
     printf("Saved in %s\n", filename);
     return 0;  // SUCCÈS
 }
 
 
+/// @brief Encodes an image as a BMP file in memory (same format as bmp24_saveImage), e.g. to send it
+/// without going through the disk.
+/// @param img Image to save.
+/// @param out Buffer receiving the file. It grows as needed, unless out->fixed is set : the save then
+/// fails when the file doesn't fit, out->size telling the size needed. out->size is the size of the file.
+/// @return 0 on success, -1 on error.
+int bmp24_saveToMemory(t_bmp24 *img, t_bmp_buffer *out) {
+    if (!img || !out) return -1;
+
+    t_bmp_writer writer = {NULL, out, 0, 0};
+    int status = writeImage24(&writer, img);
+    out->size = writer.position;
+    if (status != 0) {
+        fprintf(stderr, "Error: Could not encode the image in memory (%lu bytes needed).\n", (unsigned long)out->size);
+    }
+    return status;
+}
+
+
 
 
 /// @brief Inverts all pixel colors to create negative effect.
@@ -283,18 +1128,13 @@ void bmp24_negative(t_bmp24 *img) {
     if (!img) return;
 
     // Print original pixel values
-    printf("Original pixel (0,0): R=%d, G=%d, B=%d\n",
-           img->data[0][0].red,
-           img->data[0][0].green,
-           img->data[0][0].blue);
+    t_pixel first = bmp24_getPixel(img, 0, 0);
+    printf("Original pixel (0,0): R=%d, G=%d, B=%d\n", first.red, first.green, first.blue);
 
-    for (int y = 0; y < img->height; y++) {
-        for (int x = 0; x < img->width; x++) {
-            img->data[y][x].red = 255 - img->data[y][x].red;
-            img->data[y][x].green = 255 - img->data[y][x].green;
-            img->data[y][x].blue = 255 - img->data[y][x].blue;
-        }
-    }
+    t_image view;
+    if (image_fromBmp24(img, &view) != 0) return;
+    image_negative(&view);
+    image_free(&view);
 }
 
 /// @brief Converts image to grayscale using averaging method.
@@ -303,18 +1143,35 @@ void bmp24_grayscale(t_bmp24 *img) {
     if (!img) return;
 
     for (int y = 0; y < img->height; y++) {
-        for (int x = 0; x < img->width; x++) {
-            uint8_t gray = (img->data[y][x].red + img->data[y][x].green + img->data[y][x].blue) / 3;
-            img->data[y][x].red = gray;
-            img->data[y][x].green = gray;
-            img->data[y][x].blue = gray;
+        if (img->layout == BMP24_PLANAR) {
+            size_t row = (size_t)y * img->planeStride;
+            uint8_t *r = img->planes[0] + row, *g = img->planes[1] + row, *b = img->planes[2] + row;
+            for (int x = 0; x < img->width; x++) {
+                uint8_t gray = (r[x] + g[x] + b[x]) / 3;
+                r[x] = gray;
+                g[x] = gray;
+                b[x] = gray;
+            }
+        } else if (img->layout == BMP24_BGRA) {
+            uint8_t *p = img->bgra + (size_t)y * img->bgraStride;
+            for (int x = 0; x < img->width; x++) {
+                uint8_t gray = (p[4 * x] + p[4 * x + 1] + p[4 * x + 2]) / 3;
+                p[4 * x] = gray;
+                p[4 * x + 1] = gray;
+                p[4 * x + 2] = gray;
+            }
+        } else {
+            for (int x = 0; x < img->width; x++) {
+                uint8_t gray = (img->data[y][x].red + img->data[y][x].green + img->data[y][x].blue) / 3;
+                img->data[y][x].red = gray;
+                img->data[y][x].green = gray;
+                img->data[y][x].blue = gray;
+            }
         }
     }
     // Print modified pixel values
-    printf("Negative pixel (0,0): R=%d, G=%d, B=%d\n",
-           img->data[0][0].red,
-           img->data[0][0].green,
-           img->data[0][0].blue);
+    t_pixel first = bmp24_getPixel(img, 0, 0);
+    printf("Negative pixel (0,0): R=%d, G=%d, B=%d\n", first.red, first.green, first.blue);
 }
 
 /// @brief Adjusts image brightness by adding value to all color channels.
@@ -323,173 +1180,45 @@ void bmp24_grayscale(t_bmp24 *img) {
 void bmp24_brightness(t_bmp24 *img, int value) {
     if (!img) return;
 
-    for (int y = 0; y < img->height; y++) {
-        for (int x = 0; x < img->width; x++) {
-            int r = img->data[y][x].red + value;
-            int g = img->data[y][x].green + value;
-            int b = img->data[y][x].blue + value;
-
-            // Clamp values to [0, 255]
-            img->data[y][x].red = (r > 255) ? 255 : (r < 0 ? 0 : r);
-            img->data[y][x].green = (g > 255) ? 255 : (g < 0 ? 0 : g);
-            img->data[y][x].blue = (b > 255) ? 255 : (b < 0 ? 0 : b);
-        }
-    }
+    t_image view;
+    if (image_fromBmp24(img, &view) != 0) return;
+    image_brightness(&view, value);
+    image_free(&view);
 }
 
 /// @brief Applies box blur filter using 3x3 averaging kernel.
 /// @param img Image to blur.
 void bmp24_boxBlur(t_bmp24 *img) {
     if (!img) return;
-
-    // Define the 2D kernel
-    float kernel2D[3][3] = {
-        {1.0 / 9.0, 1.0 / 9.0, 1.0 / 9.0},
-        {1.0 / 9.0, 1.0 / 9.0, 1.0 / 9.0},
-        {1.0 / 9.0, 1.0 / 9.0, 1.0 / 9.0}
-    };
-
-    // Flatten the 2D kernel into a 1D array
-    float kernel[9];
-    int index = 0;
-    for (int i = 0; i < 3; i++) {
-        for (int j = 0; j < 3; j++) {
-            kernel[index++] = kernel2D[i][j];
-        }
-    }
-
-    t_bmp24 *copy = bmp24_allocate(img->width, img->height, img->colorDepth);
-    if (!copy) return;
-
-    for (int y = 1; y < img->height - 1; y++) {
-        for (int x = 1; x < img->width - 1; x++) {
-            copy->data[y][x] = bmp24_convolution(img, x, y, kernel, 3);
-        }
-    }
-
-    for (int y = 1; y < img->height - 1; y++) {
-        for (int x = 1; x < img->width - 1; x++) {
-            img->data[y][x] = copy->data[y][x];
-        }
-    }
-
-    bmp24_free(copy);
+    applyPreset(img, IMAGE_BOX_BLUR);
 }
 
 /// @brief Applies Gaussian blur filter for smoother blurring effect.
 /// @param img Image to apply Gaussian blur to.
 void bmp24_gaussianBlur(t_bmp24 *img) {
     if (!img) return;
-
-    float kernel[3][3] = {
-        {1.0 / 16.0, 2.0 / 16.0, 1.0 / 16.0},
-        {2.0 / 16.0, 4.0 / 16.0, 2.0 / 16.0},
-        {1.0 / 16.0, 2.0 / 16.0, 1.0 / 16.0}
-    };
-
-    t_bmp24 *copy = bmp24_allocate(img->width, img->height, img->colorDepth);
-    if (!copy) return;
-
-    for (int y = 1; y < img->height - 1; y++) {
-        for (int x = 1; x < img->width - 1; x++) {
-            copy->data[y][x] = bmp24_convolution(img, x, y, (float *)kernel, 3);
-        }
-    }
-
-    for (int y = 1; y < img->height - 1; y++) {
-        for (int x = 1; x < img->width - 1; x++) {
-            img->data[y][x] = copy->data[y][x];
-        }
-    }
-
-    bmp24_free(copy);
+    applyPreset(img, IMAGE_GAUSSIAN_BLUR);
 }
 
 /// @brief Detects and highlights edges in the image using outline kernel.
 /// @param img Image to apply outline filter to.
 void bmp24_outline(t_bmp24 *img) {
     if (!img) return;
-
-    float kernel[3][3] = {
-        {-1, -1, -1},
-        {-1, 8, -1},
-        {-1, -1, -1}
-    };
-
-    t_bmp24 *copy = bmp24_allocate(img->width, img->height, img->colorDepth);
-    if (!copy) return;
-
-    for (int y = 1; y < img->height - 1; y++) {
-        for (int x = 1; x < img->width - 1; x++) {
-            copy->data[y][x] = bmp24_convolution(img, x, y, (float *)kernel, 3);
-        }
-    }
-
-    for (int y = 1; y < img->height - 1; y++) {
-        for (int x = 1; x < img->width - 1; x++) {
-            img->data[y][x] = copy->data[y][x];
-        }
-    }
-
-    bmp24_free(copy);
+    applyPreset(img, IMAGE_OUTLINE);
 }
 
 /// @brief Creates embossed effect that gives 3D appearance to image.
 /// @param img Image to apply emboss effect to.
 void bmp24_emboss(t_bmp24 *img) {
     if (!img) return;
-
-    float kernel[3][3] = {
-        {-2, -1, 0},
-        {-1, 1, 1},
-        {0, 1, 2}
-    };
-
-    t_bmp24 *copy = bmp24_allocate(img->width, img->height, img->colorDepth);
-    if (!copy) return;
-
-    for (int y = 1; y < img->height - 1; y++) {
-        for (int x = 1; x < img->width - 1; x++) {
-            copy->data[y][x] = bmp24_convolution(img, x, y, (float *)kernel, 3);
-        }
-    }
-
-    for (int y = 1; y < img->height - 1; y++) {
-        for (int x = 1; x < img->width - 1; x++) {
-            img->data[y][x] = copy->data[y][x];
-        }
-    }
-
-    bmp24_free(copy);
+    applyPreset(img, IMAGE_EMBOSS);
 }
 
 /// @brief Sharpens image by enhancing edge details and contrast.
 /// @param img Image to sharpen.
 void bmp24_sharpen(t_bmp24 *img) {
     if (!img) return;
-
-    float kernel[3][3] = {
-        {0, -1, 0},
-        {-1, 5, -1},
-        {0, -1, 0}
-    };
-
-    t_bmp24 *copy = bmp24_allocate(img->width, img->height, img->colorDepth);
-    if (!copy) return;
-
-    for (int y = 1; y < img->height - 1; y++) {
-        for (int x = 1; x < img->width - 1; x++) {
-            copy->data[y][x] = bmp24_convolution(img, x, y, (float *)kernel, 3);
-        }
-    }
-
-    for (int y = 1; y < img->height - 1; y++) {
-        for (int x = 1; x < img->width - 1; x++) {
-            img->data[y][x] = copy->data[y][x];
-        }
-    }
-
-    bmp24_free(copy);
+    applyPreset(img, IMAGE_SHARPEN);
 }
 
 /// @brief Performs convolution operation on single pixel using given kernel.
@@ -509,7 +1238,7 @@ t_pixel bmp24_convolution(t_bmp24 *img, int x, int y, float *kernel, int kernelS
             int yj = y + j;
 
             if (xi >= 0 && xi < img->width && yj >= 0 && yj < img->height) {
-                t_pixel p = img->data[yj][xi];
+                t_pixel p = bmp24_getPixel(img, xi, yj);
                 float k = kernel[(i + n) * kernelSize + (j + n)];
                 r += p.red * k;
                 g += p.green * k;
@@ -525,4 +1254,3 @@ t_pixel bmp24_convolution(t_bmp24 *img, int x, int y, float *kernel, int kernelS
 
     return result;
 }
-
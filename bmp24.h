@@ -2,6 +2,8 @@
 #define BMP24_H
 
 #include <stdint.h>
+#include <stddef.h>
+#include "bmpio.h"
 
 
 // -------------------- HEADER ---------------------------
@@ -47,22 +49,45 @@ typedef struct {
 } t_pixel;
 
 
+// Memory layout of the pixels of a t_bmp24
+typedef enum {
+    BMP24_INTERLEAVED,   // data[y][x] is a t_pixel (default)
+    BMP24_PLANAR,        // planes[0], planes[1] and planes[2] hold the red, green and blue samples
+    BMP24_BGRA           // bgra holds 4 bytes per pixel (blue, green, red, alpha), as in 32-bit files
+} t_bmp24_layout;
+
 typedef struct {
     t_bmp_header header;
     t_bmp_info header_info;
     int width;
     int height;
-    int colorDepth;
-    t_pixel **data;
+    int colorDepth;          // 24, or 32 for images loaded from (and saved to) 32-bit files
+    t_pixel **data;          // Interleaved layout only, NULL otherwise
+    t_bmp24_layout layout;
+    uint8_t *planes[3];      // Planar layout only : rows of planeStride bytes, 32-byte aligned
+    int planeStride;
+    uint8_t *bgra;           // BGRA layout only : rows of bgraStride bytes, 32-byte aligned (unless aliased)
+    int bgraStride;
+    uint8_t *planeBuffer;    // Allocation holding the three planes or the BGRA rows (NULL when bgra points into
+                             // the buffer given to bmp24_loadFromMemory)
+    int topDown;             // Row order of the file (negative height), kept when saving. In memory, row 0 is always the top
 } t_bmp24;
 
 // Function declarations
 t_pixel **bmp24_allocateDataPixels(int width, int height);
 void bmp24_freeDataPixels(t_pixel **pixels, int height);
 t_bmp24 *bmp24_allocate(int width, int height, int colorDepth);
+t_bmp24 *bmp24_allocateLayout(int width, int height, int colorDepth, t_bmp24_layout layout);
 void bmp24_free(t_bmp24 *img);
+t_bmp24 *bmp24_copy(t_bmp24 *img);
+int bmp24_setLayout(t_bmp24 *img, t_bmp24_layout layout);
 t_bmp24 *bmp24_loadImage(const char *filename);
+t_bmp24 *bmp24_loadImageLayout(const char *filename, t_bmp24_layout layout);
+t_bmp24 *bmp24_loadRegion(const char *filename, int x, int y, int width, int height);
+t_bmp24 *bmp24_loadThumbnail(const char *filename, int maxWidth, int maxHeight);
 int bmp24_saveImage(const char *filename, t_bmp24 *img);
+t_bmp24 *bmp24_loadFromMemory(unsigned char *buffer, size_t size, int alias);
+int bmp24_saveToMemory(t_bmp24 *img, t_bmp_buffer *out);
 void bmp24_negative(t_bmp24 *img);
 void bmp24_grayscale(t_bmp24 *img);
 void bmp24_brightness(t_bmp24 *img, int value);
@@ -71,6 +96,8 @@ void bmp24_gaussianBlur(t_bmp24 *img);
 void bmp24_outline(t_bmp24 *img);
 void bmp24_emboss(t_bmp24 *img);
 void bmp24_sharpen(t_bmp24 *img);
+t_pixel bmp24_getPixel(t_bmp24 *img, int x, int y);
+void bmp24_setPixel(t_bmp24 *img, int x, int y, t_pixel p);
 t_pixel bmp24_convolution(t_bmp24 *img, int x, int y, float *kernel, int kernelSize);
 void bmp24_applyFilter(t_bmp24 *img, float *kernel, int kernelSize);
 
@@ -1,6 +1,10 @@
 #include "bmp8.h"
+#include "probe.h"
+#include "image.h"
+#include "resize.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 
 // -------------------- HEADER ---------------------------
@@ -14,6 +18,425 @@
 
 
 
+/// @brief Writes a little-endian 16 or 32-bit value into a header.
+static void putHeaderValue(unsigned char *header, int offset, uint32_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        header[offset + i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+
+/// @brief This function creates a new blank 8-bit grayscale image, with a valid BMP header and a gray color table,
+/// so operators producing a new image (e.g. from a 24-bit one) can save it directly.
+/// @param width @param height
+/// @return The new image with all pixels at 0, or NULL if the memory can't be allocated.
+
+t_bmp8 *bmp8_allocate(unsigned int width, unsigned int height) {
+    t_bmp8 *img = (t_bmp8 *)calloc(1, sizeof(t_bmp8));
+    if (!img) {
+        perror("Error allocating memory");
+        return NULL;
+    }
+
+    img->width = width;
+    img->height = height;
+    img->colorDepth = 8;
+    img->stride = (width + 3) & ~3u;
+    img->topDown = 0;
+    img->dataSize = img->stride * height;
+    img->data = (unsigned char *)calloc(img->dataSize ? img->dataSize : 1, 1);
+    if (!img->data) {
+        perror("Error allocating memory for image data");
+        free(img);
+        return NULL;
+    }
+
+    // BMP file header + info header
+    img->header[0] = 'B';
+    img->header[1] = 'M';
+    putHeaderValue(img->header, 2, 54 + 1024 + img->dataSize, 4);   // file size
+    putHeaderValue(img->header, 10, 54 + 1024, 4);                  // pixel data offset
+    putHeaderValue(img->header, 14, 40, 4);                         // info header size
+    putHeaderValue(img->header, 18, width, 4);
+    putHeaderValue(img->header, 22, height, 4);
+    putHeaderValue(img->header, 26, 1, 2);                          // planes
+    putHeaderValue(img->header, 28, 8, 2);                          // bits per pixel
+    putHeaderValue(img->header, 34, img->dataSize, 4);
+    putHeaderValue(img->header, 38, 2835, 4);                       // 72 DPI
+    putHeaderValue(img->header, 42, 2835, 4);
+    putHeaderValue(img->header, 46, 256, 4);                        // colors used
+
+    // Gray color table : entry i is (B, G, R, 0) = (i, i, i, 0)
+    for (int i = 0; i < 256; i++) {
+        img->colorTable[i * 4] = (unsigned char)i;
+        img->colorTable[i * 4 + 1] = (unsigned char)i;
+        img->colorTable[i * 4 + 2] = (unsigned char)i;
+        img->colorTable[i * 4 + 3] = 0;
+    }
+
+    return img;
+}
+
+
+
+/// @brief This function gives the address of a row of pixels, whatever the orientation of the image.
+/// @param img @param y Row index, 0 being the top of the image
+/// @return Pointer to the first pixel of the row (the row holds img->width pixels, then padding).
+
+unsigned char *bmp8_row(t_bmp8 *img, unsigned int y) {
+    unsigned int storedRow = img->topDown ? y : img->height - 1 - y;
+    return img->data + (size_t)storedRow * img->stride;
+}
+
+
+
+/// @brief This function duplicates an image (header, color table and pixels), e.g. to run a filter without
+/// modifying the original.
+/// @param img
+/// @return The copy, or NULL if the memory can't be allocated.
+
+t_bmp8 *bmp8_copy(t_bmp8 *img) {
+    if (!img || !img->data) return NULL;
+
+    t_bmp8 *copy = (t_bmp8 *)malloc(sizeof(t_bmp8));
+    if (!copy) {
+        perror("Error allocating memory");
+        return NULL;
+    }
+    *copy = *img;
+    copy->aliased = 0;
+    copy->data = (unsigned char *)malloc(img->dataSize);
+    if (!copy->data) {
+        perror("Error allocating memory for image data");
+        free(copy);
+        return NULL;
+    }
+    memcpy(copy->data, img->data, img->dataSize);
+    return copy;
+}
+
+
+
+// RLE8 escape codes (first byte 0 of a pair)
+#define RLE8_END_OF_LINE 0
+#define RLE8_END_OF_BITMAP 1
+#define RLE8_DELTA 2
+
+
+// Bytes of RLE8 data read from a file at once
+#define RLE8_READ_CHUNK (1 << 16)
+
+// Where the RLE8 decoder takes its bytes : an open file, read by chunks so the compressed data never has to be held
+// in memory whole, or a span of a buffer already in memory (bmp8_loadFromMemory)
+typedef struct {
+    FILE *file;                  // NULL for a span
+    unsigned char *chunk;        // RLE8_READ_CHUNK bytes owned by a file source
+    const unsigned char *bytes;  // The chunk, or the span
+    size_t size;                 // Bytes in bytes
+    size_t pos;
+} t_rle8_source;
+
+
+/// @brief This function gives the next byte of an RLE8 source, reading the next chunk of a file when needed.
+/// @param src
+/// @return The byte, or EOF at the end of the data.
+
+static int rle8Byte(t_rle8_source *src) {
+    if (src->pos == src->size) {
+        if (!src->file) return EOF;
+        src->size = fread(src->chunk, 1, RLE8_READ_CHUNK, src->file);
+        src->pos = 0;
+        if (src->size == 0) return EOF;
+    }
+    return src->bytes[src->pos++];
+}
+
+
+// State of an RLE8 decoding done one row at a time
+typedef struct {
+    t_rle8_source *src;
+    unsigned int x;      // column the next pixel goes to
+    unsigned int y;      // row the next pixel goes to, counted from the bottom as stored in the data
+    int ended;           // end-of-bitmap code reached : the remaining rows are 0
+} t_rle8_decoder;
+
+
+/// @brief This function decodes the next row of BI_RLE8 pixel data, one pair of bytes at a time. Rows must be asked
+/// in storage order (bottom row first). Pixels skipped by delta codes or missing lines stay at index 0.
+/// @param dec Decoder, starting at x = y = 0 @param y Row to decode, from the bottom @param row Receives width pixels
+/// @param width
+/// @return 0 on success, -1 if the data ends before the end of the row.
+
+static int decodeRle8Row(t_rle8_decoder *dec, unsigned int y, unsigned char *row, unsigned int width) {
+    memset(row, 0, width);
+    // Rows jumped over by a delta code, or after the end of the bitmap, are left at 0
+    if (dec->ended || dec->y > y) return 0;
+
+    for (;;) {
+        int count = rle8Byte(dec->src);
+        int value = rle8Byte(dec->src);
+        if (count == EOF || value == EOF) return -1;
+
+        if (count > 0) {
+            // Encoded mode : count copies of value
+            for (int k = 0; k < count && dec->x < width; k++) {
+                row[dec->x++] = (unsigned char)value;
+            }
+        } else if (value == RLE8_END_OF_LINE) {
+            dec->x = 0;
+            dec->y++;
+            return 0;
+        } else if (value == RLE8_END_OF_BITMAP) {
+            dec->ended = 1;
+            return 0;
+        } else if (value == RLE8_DELTA) {
+            int dx = rle8Byte(dec->src);
+            int dy = rle8Byte(dec->src);
+            if (dx == EOF || dy == EOF) return -1;
+            dec->x += dx;
+            dec->y += dy;
+            if (dy > 0) return 0;
+        } else {
+            // Absolute mode : value literal pixels, padded to an even number of bytes
+            for (int k = 0; k < value; k++) {
+                int pixel = rle8Byte(dec->src);
+                if (pixel == EOF) return -1;
+                if (dec->x < width) row[dec->x++] = (unsigned char)pixel;
+            }
+            if (value & 1) rle8Byte(dec->src);
+        }
+    }
+}
+
+
+/// @brief This function decodes all the BI_RLE8 pixel data of an image.
+/// @param src Source positioned at the start of the pixel data @param img Image with its (bottom-up) data allocated
+/// @return 0 on success, -1 if the data ends before the end-of-bitmap code.
+
+static int decodeRle8(t_rle8_source *src, t_bmp8 *img) {
+    t_rle8_decoder dec = {src, 0, 0, 0};
+    memset(img->data, 0, img->dataSize);
+    for (unsigned int y = 0; y < img->height; y++) {
+        if (decodeRle8Row(&dec, y, img->data + (size_t)y * img->stride, img->width) != 0) return -1;
+    }
+    return 0;
+}
+
+
+/// @brief This function encodes a row of pixels in BI_RLE8 (without the end-of-line code). Runs of at least
+/// two equal pixels use the encoded mode, other pixels are grouped in absolute mode when there are three or more.
+/// @param row @param width @param writer
+/// @return The number of bytes written.
+
+static unsigned int encodeRle8Row(const unsigned char *row, unsigned int width, t_bmp_writer *writer) {
+    unsigned int written = 0;
+    unsigned int x = 0;
+
+    while (x < width) {
+        unsigned int run = 1;
+        while (x + run < width && run < 255 && row[x + run] == row[x]) run++;
+        if (run >= 2) {
+            bmp_writeByte(writer, run);
+            bmp_writeByte(writer, row[x]);
+            written += 2;
+            x += run;
+            continue;
+        }
+
+        // Literal pixels, until three equal pixels start a run worth encoding
+        unsigned int start = x;
+        while (x < width && x - start < 255 &&
+               !(x + 2 < width && row[x] == row[x + 1] && row[x] == row[x + 2])) {
+            x++;
+        }
+        unsigned int n = x - start;
+        if (n < 3) {
+            // The absolute mode needs at least 3 pixels
+            for (unsigned int k = start; k < x; k++) {
+                bmp_writeByte(writer, 1);
+                bmp_writeByte(writer, row[k]);
+                written += 2;
+            }
+        } else {
+            bmp_writeByte(writer, 0);
+            bmp_writeByte(writer, n);
+            bmp_write(writer, row + start, n);
+            written += 2 + n;
+            if (n & 1) {
+                bmp_writeByte(writer, 0);
+                written++;
+            }
+        }
+    }
+    return written;
+}
+
+
+
+/// @brief This function checks the headers held by img->header, and sets the size, stride, orientation and
+/// compression of the image.
+/// @param img @param offset Receives the offset of the pixel data
+/// @return 0 on success, -1 if the file is not a supported 8-bit BMP file.
+
+static int parseHeader8(t_bmp8 *img, uint32_t *offset) {
+    // Validate the BMP signature and decode the fields (the header bytes are not aligned for direct loads)
+    t_bmp_header header;
+    t_bmp_info info;
+    if (bmp_parseHeader(img->header, &header, &info) != 0) return -1;
+
+    // Extract key info. A negative height means the rows are stored top-down.
+    int32_t height = info.height;
+    uint32_t compression = info.compression;
+    *offset = header.offset;
+    img->width = info.width;
+    img->topDown = height < 0;
+    img->height = height < 0 ? -height : height;
+    img->colorDepth = info.bits;
+
+    // Rows are padded to 4 bytes; the size field of the header is ignored (some BMPs set it to 0)
+    img->stride = (img->width + 3) & ~3u;
+    img->dataSize = img->stride * img->height;
+
+    // Debug info
+    printf("DEBUG: Width=%u, Height=%u, ColorDepth=%u, DataSize=%u\n",
+        img->width, img->height, img->colorDepth, img->dataSize);
+
+    // Reject unsupported formats (RLE8 files are always stored bottom-up)
+    img->compression = compression;
+    if (img->colorDepth != 8 || (compression != BMP8_RGB && compression != BMP8_RLE8) ||
+        (compression == BMP8_RLE8 && img->topDown)) {
+        fprintf(stderr, "Unsupported BMP format: Only uncompressed or RLE8 8-bit grayscale BMPs are supported.\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+
+/// @brief This function gives where the color table of an 8-bit BMP file is (right after the info header) and how
+/// many entries it has (up to 256, of 4 bytes each).
+/// @param img Image whose header is set @param start @param colors
+
+static void colorTableSpan(const t_bmp8 *img, uint32_t *start, unsigned int *colors) {
+    t_bmp_header header;
+    t_bmp_info info;
+    bmp_parseHeader(img->header, &header, &info);
+    *start = 14 + info.size;
+    *colors = (info.ncolors == 0 || info.ncolors > 256) ? 256 : info.ncolors;
+}
+
+
+/// @brief This function reads the color table of an open 8-bit BMP file.
+/// @param file @param img Image whose header is set
+/// @return 0 on success, -1 on a read error.
+
+static int readColorTable(FILE *file, t_bmp8 *img) {
+    uint32_t start;
+    unsigned int colors;
+    colorTableSpan(img, &start, &colors);
+    memset(img->colorTable, 0, sizeof(img->colorTable));
+    fseek(file, start, SEEK_SET);
+    if (fread(img->colorTable, 4, colors, file) != colors) {
+        fprintf(stderr, "Error reading color table.\n");
+        return -1;
+    }
+    return 0;
+}
+
+
+/// @brief This function reads and checks the headers and the color table of an 8-bit BMP file, and sets the size,
+/// stride, orientation and compression of the image.
+/// @param file File positioned at its start @param img @param offset Receives the offset of the pixel data
+/// @return 0 on success, -1 if the file is not a supported 8-bit BMP file.
+static int readHeader8(FILE *file, t_bmp8 *img, uint32_t *offset) {
+    if (fread(img->header, 1, 54, file) != 54) {
+        fprintf(stderr, "Error reading BMP header\n");
+        return -1;
+    }
+    if (parseHeader8(img, offset) != 0) return -1;
+    return readColorTable(file, img);
+}
+
+
+
+/// @brief This function reads the pixels of an open 8-bit BMP file whose headers are in img. They are either kept
+/// in img->data (allocated here), or added row by row to a box average (thumbnails) : the file is then read, or its
+/// RLE8 data decoded, one row at a time into a single row buffer.
+/// @param file @param offset Offset of the pixel data @param img @param box Box average receiving the rows, or NULL
+/// @return 0 on success, -1 on error (img->data is then left NULL).
+
+static int readPixels8(FILE *file, uint32_t offset, t_bmp8 *img, t_resize_box *box) {
+    // Allocate memory for image data (a single row for a thumbnail)
+    img->data = (unsigned char *)malloc(box ? img->stride : img->dataSize);
+    if (!img->data) {
+        perror("Error allocating memory for image data");
+        return -1;
+    }
+
+    // Read pixel data, padded rows included, in a single read (RLE8 data is decoded as it is read)
+    fseek(file, offset, SEEK_SET);
+    t_rle8_source source = {file, NULL, NULL, 0, 0};
+    t_rle8_decoder dec = {&source, 0, 0, 0};
+    int status = 0;
+    if (img->compression == BMP8_RLE8) {
+        source.chunk = (unsigned char *)malloc(RLE8_READ_CHUNK);
+        source.bytes = source.chunk;
+        if (!source.chunk) status = -1;
+    }
+    if (status == 0 && box) {
+        // Rows come in storage order : bottom-up unless the file is top-down (never for RLE8)
+        for (unsigned int i = 0; i < img->height && status == 0; i++) {
+            if (img->compression == BMP8_RLE8) {
+                status = decodeRle8Row(&dec, i, img->data, img->width);
+            } else if (fread(img->data, 1, img->stride, file) < img->width) {
+                status = -1;
+            }
+            if (status == 0) resize_boxAddRow(box, img->topDown ? i : img->height - 1 - i, img->data);
+        }
+    } else if (status == 0 && (img->compression == BMP8_RLE8 ? decodeRle8(&source, img) != 0
+                                                             : fread(img->data, 1, img->dataSize, file) != img->dataSize)) {
+        status = -1;
+    }
+
+    free(source.chunk);
+    if (status != 0) fprintf(stderr, "Error reading pixel data.\n");
+    if (status != 0 || box) {
+        free(img->data);
+        img->data = NULL;
+    }
+    return status;
+}
+
+
+/// @brief This function reads the headers (unless they are given) and the pixels of an open 8-bit BMP file.
+/// @param file The file, positioned at its start when header is NULL. It is left open.
+/// @param header The 54 header bytes already read from the file, or NULL
+/// @return Pointer to the loaded image, or NULL on error.
+
+static t_bmp8 *loadFile8(FILE *file, const unsigned char *header) {
+    t_bmp8 *img = (t_bmp8 *)calloc(1, sizeof(t_bmp8));
+    if (!img) {
+        perror("Error allocating memory");
+        return NULL;
+    }
+
+    uint32_t offset;
+    if (header) memcpy(img->header, header, 54);
+    if (header ? parseHeader8(img, &offset) != 0 || readColorTable(file, img) != 0
+               : readHeader8(file, img, &offset) != 0) {
+        free(img);
+        return NULL;
+    }
+
+    if (readPixels8(file, offset, img, NULL) != 0) {
+        free(img);
+        return NULL;
+    }
+    return img;
+}
+
+
+
 /// @brief This function must load the image with a pointer to the filename, while checking if it is valid (depth, headers, etc...)
 /// @param filename 
 /// @return An error if the file can't be open, else, the dynamically attribute memory for the image data.
@@ -25,78 +448,146 @@ t_bmp8 *bmp8_loadImage(const char *filename) {
         perror("Error opening file");
         return NULL;
     }
+    t_bmp8 *img = loadFile8(file, NULL);
+    fclose(file);
+    return img;
+}
 
-    t_bmp8 *img = (t_bmp8 *)malloc(sizeof(t_bmp8));
-    if (!img) {
-        perror("Error allocating memory");
-        fclose(file);
+
+/// @brief This function loads the 8-bit image of a probed file, reusing its open file and its headers.
+/// The file of the probe is closed, whether loading succeeds or not.
+/// @param probe A probe filled by bmp_probe
+/// @return Pointer to the loaded image, or NULL on error.
+
+t_bmp8 *bmp8_loadFromProbe(t_bmp_probe *probe) {
+    if (!probe || !probe->file) {
+        fprintf(stderr, "Error: The probe has no open file.\n");
         return NULL;
     }
+    t_bmp8 *img = loadFile8(probe->file, probe->raw);
+    bmp_probeClose(probe);
+    return img;
+}
 
-    // Read BMP header
-    if (fread(img->header, 1, 54, file) != 54) {
-        fprintf(stderr, "Error reading BMP header\n");
-        free(img);
-        fclose(file);
+
+
+/// @brief This function loads an 8-bit BMP file reduced to fit in maxWidth x maxHeight (aspect ratio kept, never
+/// enlarged). Each pixel is the average of the box of file pixels it covers, summed while the rows are read (RLE8
+/// rows are decoded one at a time), so a file of any size costs one file row and one row of sums besides the thumbnail.
+/// @param filename @param maxWidth @param maxHeight Largest size of the thumbnail
+/// @return The thumbnail (same color table, orientation and compression as the file), or NULL on error.
+
+t_bmp8 *bmp8_loadThumbnail(const char *filename, int maxWidth, int maxHeight) {
+    if (maxWidth < 1 || maxHeight < 1) return NULL;
+    FILE *file = fopen(filename, "rb");
+    if (!file) {
+        perror("Error opening file");
         return NULL;
     }
 
-    // Validate BMP signature
-    if (img->header[0] != 'B' || img->header[1] != 'M') {
-        fprintf(stderr, "Not a valid BMP file (missing 'BM' signature).\n");
-        free(img);
+    t_bmp8 header;
+    uint32_t offset;
+    if (readHeader8(file, &header, &offset) != 0) {
         fclose(file);
         return NULL;
     }
 
-    // Extract key info
-    img->width = *(uint32_t *)&img->header[18];
-    img->height = *(uint32_t *)&img->header[22];
-    img->colorDepth = *(uint16_t *)&img->header[28];
-    img->dataSize = *(uint32_t *)&img->header[34];
+    int width, height;
+    resize_fitSize(header.width, header.height, maxWidth, maxHeight, &width, &height);
+    t_bmp8 *img = bmp8_allocate(width, height);
+    int status = -1;
+    if (img) {
+        t_image view;
+        t_resize_box box;
+        memcpy(img->colorTable, header.colorTable, sizeof(img->colorTable));
+        img->topDown = header.topDown;
+        img->compression = header.compression;
+        if (image_fromBmp8(img, &view) == 0) {
+            if (resize_boxBegin(&box, &view, header.width, header.height) == 0) {
+                status = readPixels8(file, offset, &header, &box);
+                resize_boxEnd(&box);
+            }
+            image_free(&view);
+        }
+    }
+    fclose(file);
 
-    // Fallback data size (some BMPs set it to 0)
-    if (img->dataSize == 0) {
-        img->dataSize = img->width * img->height;
+    if (status != 0) {
+        bmp8_free(img);
+        return NULL;
     }
+    return img;
+}
 
-    // Debug info
-    printf("DEBUG: Width=%u, Height=%u, ColorDepth=%u, DataSize=%u\n",
-        img->width, img->height, img->colorDepth, img->dataSize);
 
-    // Reject unsupported formats
-    if (img->colorDepth != 8) {
-        fprintf(stderr, "Unsupported BMP format: Only 8-bit grayscale BMPs are supported.\n");
-        free(img);
-        fclose(file);
+
+/// @brief This function loads only a rectangle of an 8-bit BMP file. Uncompressed rows are directly addressable, so
+/// each row of the region costs one seek and one read of exactly its bytes. RLE8 files can't be addressed : they are
+/// decoded whole and the region is copied out.
+/// @param filename @param x @param y Top-left corner of the region (row 0 is the top of the image)
+/// @param width @param height Size of the region, clipped to the image
+/// @return The region as a new image (same orientation and compression as the file), or NULL on error.
+
+t_bmp8 *bmp8_loadRegion(const char *filename, int x, int y, int width, int height) {
+    FILE *file = fopen(filename, "rb");
+    if (!file) {
+        perror("Error opening file");
         return NULL;
     }
+    // Unbuffered : every read fetches the bytes of one region row and nothing more
+    setvbuf(file, NULL, _IONBF, 0);
 
-    // Read color table (1024 bytes = 256 entries × 4 bytes)
-    if (fread(img->colorTable, 1, 1024, file) != 1024) {
-        fprintf(stderr, "Error reading color table.\n");
-        free(img);
+    t_bmp8 header;
+    uint32_t offset;
+    if (readHeader8(file, &header, &offset) != 0) {
         fclose(file);
         return NULL;
     }
 
-    // Allocate memory for image data
-    img->data = (unsigned char *)malloc(img->dataSize);
-    if (!img->data) {
-        perror("Error allocating memory for image data");
-        free(img);
+    int x0 = x < 0 ? 0 : x, y0 = y < 0 ? 0 : y;
+    int x1 = x + width > (int)header.width ? (int)header.width : x + width;
+    int y1 = y + height > (int)header.height ? (int)header.height : y + height;
+    if (x1 <= x0 || y1 <= y0) {
+        fprintf(stderr, "Region is outside of the image.\n");
         fclose(file);
         return NULL;
     }
 
-    // Read pixel data
-    if (fread(img->data, 1, img->dataSize, file) != img->dataSize) {
-        fprintf(stderr, "Error reading pixel data.\n");
-        free(img->data);
-        free(img);
+    t_bmp8 *img = bmp8_allocate(x1 - x0, y1 - y0);
+    if (!img) {
         fclose(file);
         return NULL;
     }
+    memcpy(img->colorTable, header.colorTable, sizeof(img->colorTable));
+    img->topDown = header.topDown;
+    img->compression = header.compression;
+
+    if (header.compression == BMP8_RLE8) {
+        fclose(file);
+        t_bmp8 *full = bmp8_loadImage(filename);
+        if (!full) {
+            bmp8_free(img);
+            return NULL;
+        }
+        for (unsigned int r = 0; r < img->height; r++) {
+            memcpy(bmp8_row(img, r), bmp8_row(full, y0 + r) + x0, img->width);
+        }
+        bmp8_free(full);
+        return img;
+    }
+
+    // Rows of the region in file order : top-down files start at row y0, bottom-up files at row height - y1
+    int firstFileRow = header.topDown ? y0 : (int)header.height - y1;
+    for (unsigned int i = 0; i < img->height; i++) {
+        long fileRow = firstFileRow + i;
+        fseek(file, offset + fileRow * header.stride + x0, SEEK_SET);
+        if (fread(img->data + (size_t)i * img->stride, 1, img->width, file) != img->width) {
+            fprintf(stderr, "Error reading pixel data.\n");
+            bmp8_free(img);
+            fclose(file);
+            return NULL;
+        }
+    }
 
     fclose(file);
     return img;
@@ -104,6 +595,52 @@ t_bmp8 *bmp8_loadImage(const char *filename) {
 
 
 
+/// @brief This function writes a whole 8-bit BMP file (headers, color table and pixels) to a writer.
+/// @param writer A file or a memory buffer @param img
+/// @return 0 on success, -1 if a write fails.
+
+static int writeImage8(t_bmp_writer *writer, t_bmp8 *img) {
+    // The header is rewritten for what is saved : 40-byte info header, full color table, padded rows
+    // (RLE8 sizes are only known once the data is written, they are patched at the end)
+    unsigned char header[54];
+    memcpy(header, img->header, 54);
+    int32_t height = (img->topDown && img->compression != BMP8_RLE8) ? -(int32_t)img->height : (int32_t)img->height;
+    header[0] = 'B';
+    header[1] = 'M';
+    putHeaderValue(header, 2, 54 + 1024 + img->dataSize, 4);
+    putHeaderValue(header, 10, 54 + 1024, 4);
+    putHeaderValue(header, 14, 40, 4);
+    putHeaderValue(header, 18, img->width, 4);
+    putHeaderValue(header, 22, (uint32_t)height, 4);
+    putHeaderValue(header, 30, img->compression == BMP8_RLE8 ? BMP8_RLE8 : BMP8_RGB, 4);
+    putHeaderValue(header, 34, img->dataSize, 4);
+    putHeaderValue(header, 46, 256, 4);
+
+    bmp_write(writer, header, 54);
+    bmp_write(writer, img->colorTable, 1024);
+
+    if (img->compression == BMP8_RLE8) {
+        // Rows bottom-up, an end-of-line code after each row but the last, then the end-of-bitmap code
+        unsigned int encodedSize = 0;
+        for (unsigned int i = 0; i < img->height; i++) {
+            encodedSize += encodeRle8Row(bmp8_row(img, img->height - 1 - i), img->width, writer);
+            bmp_writeByte(writer, 0);
+            bmp_writeByte(writer, i + 1 < img->height ? RLE8_END_OF_LINE : RLE8_END_OF_BITMAP);
+            encodedSize += 2;
+        }
+
+        putHeaderValue(header, 2, 54 + 1024 + encodedSize, 4);
+        putHeaderValue(header, 34, encodedSize, 4);
+        bmp_writePatch(writer, 0, header, 54);
+    } else {
+        bmp_write(writer, img->data, img->dataSize);
+    }
+
+    return writer->error ? -1 : 0;
+}
+
+
+
 /// @brief This function allow the user to save the image, with error handling 
 /// @param filename @param img
 /// @return An error if the file can't be open, else it writes the file directly.
@@ -115,29 +652,97 @@ int bmp8_saveImage(const char *filename, t_bmp8 *img) {
         return -1;
     }
 
+    t_bmp_writer writer = {file, NULL, 0, 0};
+    int status = writeImage8(&writer, img);
+    if (fclose(file) != 0) status = -1;
+    if (status != 0) {
+        perror("Error writing image data");
+    }
+    return status;
+}
 
-    if (fwrite(img->header, 1, 54, file) != 54) {
-        perror("Error writing header");
-        fclose(file);
-        return -1;
+
+
+/// @brief This function encodes an 8-bit image as a BMP file in memory, e.g. to send it without going through the disk.
+/// @param img @param out Buffer receiving the file : it grows as needed, unless out->fixed is set (the save then fails
+/// when the file doesn't fit, with out->size telling the size needed). out->size is the size of the file.
+/// @return 0 on success, -1 on error.
+
+int bmp8_saveToMemory(t_bmp8 *img, t_bmp_buffer *out) {
+    if (!img || !img->data || !out) return -1;
+
+    t_bmp_writer writer = {NULL, out, 0, 0};
+    int status = writeImage8(&writer, img);
+    out->size = writer.position;
+    if (status != 0) {
+        fprintf(stderr, "Error: Could not encode the image in memory (%lu bytes needed).\n", (unsigned long)out->size);
     }
+    return status;
+}
 
 
-    if (fwrite(img->colorTable, 1, 1024, file) != 1024) {
-        perror("Error writing color table");
-        fclose(file);
-        return -1;
+
+/// @brief This function decodes an 8-bit BMP file held in memory. The pixels of an uncompressed file are stored
+/// exactly as in memory, so with alias set the image uses the rows of the buffer instead of a copy : the buffer
+/// must then outlive the image, and the filters modify it in place.
+/// @param buffer @param size The whole file @param alias Non-zero to point into the buffer when possible
+/// @return Pointer to the image, or NULL if the buffer is not a supported (or is a truncated) 8-bit BMP file.
+
+t_bmp8 *bmp8_loadFromMemory(unsigned char *buffer, size_t size, int alias) {
+    if (!buffer || size < 54) {
+        fprintf(stderr, "Error reading BMP header\n");
+        return NULL;
     }
 
+    t_bmp8 *img = (t_bmp8 *)calloc(1, sizeof(t_bmp8));
+    if (!img) {
+        perror("Error allocating memory");
+        return NULL;
+    }
 
-    if (fwrite(img->data, 1, img->dataSize, file) != img->dataSize) {
-        perror("Error writing image data");
-        fclose(file);
-        return -1;
+    uint32_t offset, start;
+    unsigned int colors;
+    memcpy(img->header, buffer, 54);
+    if (parseHeader8(img, &offset) != 0) {
+        free(img);
+        return NULL;
     }
 
-    fclose(file);
-    return 0;
+    colorTableSpan(img, &start, &colors);
+    if (start > size || (size - start) / 4 < colors || offset > size) {
+        fprintf(stderr, "Error: Truncated BMP file.\n");
+        free(img);
+        return NULL;
+    }
+    memcpy(img->colorTable, buffer + start, (size_t)colors * 4);
+
+    if (img->compression == BMP8_RGB && alias) {
+        if (size - offset < img->dataSize) {
+            fprintf(stderr, "Error reading pixel data.\n");
+            free(img);
+            return NULL;
+        }
+        img->data = buffer + offset;
+        img->aliased = 1;
+        return img;
+    }
+
+    img->data = (unsigned char *)malloc(img->dataSize ? img->dataSize : 1);
+    if (!img->data) {
+        perror("Error allocating memory for image data");
+        free(img);
+        return NULL;
+    }
+    t_rle8_source span = {NULL, NULL, buffer + offset, size - offset, 0};
+    if (img->compression == BMP8_RLE8 ? decodeRle8(&span, img) != 0
+                                      : size - offset < img->dataSize) {
+        fprintf(stderr, "Error reading pixel data.\n");
+        free(img->data);
+        free(img);
+        return NULL;
+    }
+    if (img->compression == BMP8_RGB) memcpy(img->data, buffer + offset, img->dataSize);
+    return img;
 }
 
 
@@ -147,7 +752,7 @@ int bmp8_saveImage(const char *filename, t_bmp8 *img) {
 
 void bmp8_free(t_bmp8 *img) {
     if (img) {
-        if (img->data) {
+        if (img->data && !img->aliased) {
             free(img->data);
         }
         free(img);
@@ -167,6 +772,7 @@ void bmp8_printInfo(t_bmp8 *img) {
         printf("    Height: %u\n", img->height);
         printf("    Color Depth: %u\n", img->colorDepth);
         printf("    Data Size: %u\n", img->dataSize);
+        printf("    Compression: %s\n", img->compression == BMP8_RLE8 ? "RLE8" : "none");
     }
 }
 
@@ -175,11 +781,10 @@ void bmp8_printInfo(t_bmp8 *img) {
 /// @param img 
 /// @return VOID
 void bmp8_negative(t_bmp8 *img) {
-    if (img && img->data) {
-        for (unsigned int i = 0; i < img->dataSize; i++) {
-            img->data[i] = 255 - img->data[i];
-        }
-    }
+    t_image view;
+    if (image_fromBmp8(img, &view) != 0) return;
+    image_negative(&view);
+    image_free(&view);
 }
 
 
@@ -190,17 +795,10 @@ void bmp8_negative(t_bmp8 *img) {
 
 
 void bmp8_brightness(t_bmp8 *img, int value) {
-    if (img && img->data) {
-        for (unsigned int i = 0; i < img->dataSize; i++) {
-            int newValue = img->data[i] + value;
-            if (newValue > 255) {
-                newValue = 255;
-            } else if (newValue < 0) {
-                newValue = 0;
-            }
-            img->data[i] = (unsigned char)newValue;
-        }
-    }
+    t_image view;
+    if (image_fromBmp8(img, &view) != 0) return;
+    image_brightness(&view, value);
+    image_free(&view);
 }
 /// @brief This converts a grayscale image to a binary (black and white) image based on the given threshold. If the treshold is 100 and a pixel has value = 80, it become 0.
 /// If it has 120 as value, it becomes 255
@@ -211,17 +809,16 @@ void bmp8_brightness(t_bmp8 *img, int value) {
 
 
 void bmp8_threshold(t_bmp8 *img, int threshold) {
-    if (img && img->data) {
-        for (unsigned int i = 0; i < img->dataSize; i++) {
-            img->data[i] = (img->data[i] >= threshold) ? 255 : 0;
-        }
-    }
+    t_image view;
+    if (image_fromBmp8(img, &view) != 0) return;
+    image_threshold(&view, threshold);
+    image_free(&view);
 }
 
 
 
 
-///@brief This function apply the specified filter to the input data.
+///@brief This function apply the specified filter to the input data. Kernel rows go from the top to the bottom of the image.
 
 ///@param input Pointer to the input data to be filtered.
 ///@param filter_params Structure containing filter configuration parameters.
@@ -233,33 +830,61 @@ void bmp8_applyFilter(t_bmp8 *img, float **kernel, int kernelSize) {
         return;
     }
 
-    int n = kernelSize / 2;
-    unsigned char *newData = (unsigned char *)malloc(img->dataSize);
-    if (!newData) {
-        perror("Error allocating memory for new image data");
+    float *rows = (float *)malloc((size_t)kernelSize * kernelSize * sizeof(float));
+    if (!rows) {
+        perror("Error allocating memory for the kernel");
         return;
     }
+    for (int i = 0; i < kernelSize; i++) {
+        memcpy(rows + (size_t)i * kernelSize, kernel[i], kernelSize * sizeof(float));
+    }
 
-    for (int y = 1; y < img->height - 1; y++) {
-        for (int x = 1; x < img->width - 1; x++) {
-            float sum = 0.0f;
-            for (int i = -n; i <= n; i++) {
-                for (int j = -n; j <= n; j++) {
-                    int pixelValue = img->data[(y + i) * img->width + (x + j)];
-                    sum += pixelValue * kernel[i + n][j + n];
-                }
-            }
-            newData[y * img->width + x] = (unsigned char)sum;
-        }
+    // Pixels closer to the edge than max(n, 1) are left unchanged
+    int n = kernelSize / 2;
+    t_image view;
+    if (image_fromBmp8(img, &view) == 0) {
+        image_convolve(&view, rows, kernelSize, n > 1 ? n : 1, IMAGE_TRUNCATE);
+        image_free(&view);
     }
+    free(rows);
+}
 
 
-    for (int y = 1; y < img->height - 1; y++) {
-        for (int x = 1; x < img->width - 1; x++) {
-            img->data[y * img->width + x] = newData[y * img->width + x];
-        }
-    }
+/// @brief Applies one of the preset 3x3 kernels, leaving the one pixel border unchanged.
+static void applyPreset8(t_bmp8 *img, t_image_kernel kernel) {
+    t_image view;
+    if (image_fromBmp8(img, &view) != 0) return;
+    image_convolve(&view, image_presetKernel(kernel), 3, 1, IMAGE_TRUNCATE);
+    image_free(&view);
+}
 
-    free(newData);
+
+/// @brief Applies box blur filter using 3x3 averaging kernel.
+/// @param img Image to blur.
+void bmp8_boxBlur(t_bmp8 *img) {
+    applyPreset8(img, IMAGE_BOX_BLUR);
+}
+
+/// @brief Applies Gaussian blur filter for smoother blurring effect.
+/// @param img Image to apply Gaussian blur to.
+void bmp8_gaussianBlur(t_bmp8 *img) {
+    applyPreset8(img, IMAGE_GAUSSIAN_BLUR);
+}
+
+/// @brief Detects and highlights edges in the image using outline kernel.
+/// @param img Image to apply outline filter to.
+void bmp8_outline(t_bmp8 *img) {
+    applyPreset8(img, IMAGE_OUTLINE);
+}
+
+/// @brief Creates embossed effect that gives 3D appearance to image.
+/// @param img Image to apply emboss effect to.
+void bmp8_emboss(t_bmp8 *img) {
+    applyPreset8(img, IMAGE_EMBOSS);
 }
 
+/// @brief Sharpens image by enhancing edge details and contrast.
+/// @param img Image to sharpen.
+void bmp8_sharpen(t_bmp8 *img) {
+    applyPreset8(img, IMAGE_SHARPEN);
+}
@@ -13,8 +13,12 @@
 
 
 #include <stdint.h>
+#include <stddef.h>
+#include "bmpio.h"
 
 // Define the t_bmp8 structure
+// The pixels are kept exactly as in the file : rows of stride bytes (width rounded up to a multiple of 4),
+// stored bottom-up unless topDown is set (negative height in the header). Use bmp8_row to reach a row.
 typedef struct {
     unsigned char header[54];
     unsigned char colorTable[1024];
@@ -22,18 +26,38 @@ typedef struct {
     unsigned int width;
     unsigned int height;
     unsigned int colorDepth;
-    unsigned int dataSize;
+    unsigned int dataSize;   // stride * height
+    unsigned int stride;     // bytes per row, padding included
+    int topDown;             // 1 if the first row of data is the top of the image
+    unsigned int compression; // BMP8_RGB or BMP8_RLE8 : how the file was stored, and how it is saved
+    int aliased;             // 1 if data points into the buffer given to bmp8_loadFromMemory (not freed)
 } t_bmp8;
 
+// Values of the compression field
+#define BMP8_RGB 0
+#define BMP8_RLE8 1
 
+
+t_bmp8 *bmp8_allocate(unsigned int width, unsigned int height);
+unsigned char *bmp8_row(t_bmp8 *img, unsigned int y);
+t_bmp8 *bmp8_copy(t_bmp8 *img);
 t_bmp8 *bmp8_loadImage(const char *filename);
+t_bmp8 *bmp8_loadRegion(const char *filename, int x, int y, int width, int height);
+t_bmp8 *bmp8_loadThumbnail(const char *filename, int maxWidth, int maxHeight);
 int bmp8_saveImage(const char *filename, t_bmp8 *img);
+t_bmp8 *bmp8_loadFromMemory(unsigned char *buffer, size_t size, int alias);
+int bmp8_saveToMemory(t_bmp8 *img, t_bmp_buffer *out);
 void bmp8_free(t_bmp8 *img);
 void bmp8_printInfo(t_bmp8 *img);
 void bmp8_negative(t_bmp8 *img);
 void bmp8_brightness(t_bmp8 *img, int value);
 void bmp8_threshold(t_bmp8 *img, int threshold);
 void bmp8_applyFilter(t_bmp8 *img, float **kernel, int kernelSize);
+void bmp8_boxBlur(t_bmp8 *img);
+void bmp8_gaussianBlur(t_bmp8 *img);
+void bmp8_outline(t_bmp8 *img);
+void bmp8_emboss(t_bmp8 *img);
+void bmp8_sharpen(t_bmp8 *img);
 void applyFilters8(t_bmp8 *img);
 
 #endif
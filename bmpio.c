@@ -0,0 +1,82 @@
+#include "bmpio.h"
+#include <stdlib.h>
+#include <string.h>
+
+// -------------------- HEADER ---------------------------
+//  Name : bmpio.c
+//  Goal : byte sinks shared by the 8-bit and 24-bit savers : a FILE, or a fixed or growable memory buffer
+//  Authors : Amel Boulhamane and Tom Hausmann
+// 
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments 
+//
+// --------------------------------------------------------
+
+
+/// @brief Makes room for count more bytes in the memory buffer of a writer, doubling its capacity when it grows.
+/// @return 0 on success, -1 if a fixed buffer is too small or if memory allocation fails.
+static int reserve(t_bmp_writer *writer, size_t count) {
+    t_bmp_buffer *buffer = writer->buffer;
+    size_t needed = writer->position + count;
+    if (needed <= buffer->capacity) return 0;
+    if (buffer->fixed) return -1;
+
+    size_t capacity = buffer->capacity ? buffer->capacity : 4096;
+    while (capacity < needed) capacity *= 2;
+    unsigned char *data = (unsigned char *)realloc(buffer->data, capacity);
+    if (!data) return -1;
+    buffer->data = data;
+    buffer->capacity = capacity;
+    return 0;
+}
+
+
+/// @brief Appends bytes to the output of a writer.
+/// @param writer The writer.
+/// @param bytes @param count Bytes to write.
+void bmp_write(t_bmp_writer *writer, const void *bytes, size_t count) {
+    if (!writer->error) {
+        if (writer->file) {
+            if (fwrite(bytes, 1, count, writer->file) != count) writer->error = 1;
+        } else if (reserve(writer, count) != 0) {
+            writer->error = 1;
+        } else {
+            memcpy(writer->buffer->data + writer->position, bytes, count);
+        }
+    }
+    // Counted even after an error, so that the size a fixed buffer would need is known
+    writer->position += count;
+}
+
+
+/// @brief Appends a single byte to the output of a writer.
+/// @param writer The writer.
+/// @param byte Value of the byte.
+void bmp_writeByte(t_bmp_writer *writer, int byte) {
+    if (!writer->error && writer->file) {
+        if (putc(byte, writer->file) == EOF) writer->error = 1;
+        writer->position++;
+        return;
+    }
+    unsigned char value = (unsigned char)byte;
+    bmp_write(writer, &value, 1);
+}
+
+
+/// @brief Rewrites bytes already written, e.g. the sizes of a header only known once the pixels are written.
+/// @param writer The writer.
+/// @param position Offset of the bytes in the output.
+/// @param bytes @param count New value of the bytes.
+void bmp_writePatch(t_bmp_writer *writer, size_t position, const void *bytes, size_t count) {
+    if (writer->error || position + count > writer->position) return;
+
+    if (writer->file) {
+        long end = ftell(writer->file);
+        if (fseek(writer->file, (long)position, SEEK_SET) != 0 ||
+            fwrite(bytes, 1, count, writer->file) != count ||
+            fseek(writer->file, end, SEEK_SET) != 0) {
+            writer->error = 1;
+        }
+    } else {
+        memcpy(writer->buffer->data + position, bytes, count);
+    }
+}
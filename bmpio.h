@@ -0,0 +1,38 @@
+#ifndef BMPIO_H
+#define BMPIO_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+// -------------------- HEADER ---------------------------
+//  Name : bmpio.h
+//  Goal : let the savers write either to a file or to a memory buffer
+//  Authors : Amel Boulhamane and Tom Hausmann
+// 
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments 
+//
+// --------------------------------------------------------
+
+
+// An encoded BMP file in memory, filled by bmp8_saveToMemory and bmp24_saveToMemory
+typedef struct {
+    unsigned char *data;   // The bytes. NULL, or a block from malloc that is reused, when the buffer can grow
+    size_t size;           // Bytes of the file (when a fixed buffer is too small : the size it would need)
+    size_t capacity;       // Bytes available in data
+    int fixed;             // 1 if data is a buffer of the caller that must not be reallocated
+} t_bmp_buffer;
+
+// Where a saver writes : an open file, or a memory buffer
+typedef struct {
+    FILE *file;
+    t_bmp_buffer *buffer;
+    size_t position;       // Bytes written so far
+    int error;             // Set by a failed write, the following writes are ignored
+} t_bmp_writer;
+
+
+void bmp_write(t_bmp_writer *writer, const void *bytes, size_t count);
+void bmp_writeByte(t_bmp_writer *writer, int byte);
+void bmp_writePatch(t_bmp_writer *writer, size_t position, const void *bytes, size_t count);
+
+#endif // BMPIO_H
@@ -0,0 +1,244 @@
+#include "canny.h"
+#include "gradient.h"
+#include "plane.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// -------------------- HEADER ---------------------------
+//  Name : canny.c
+//  Goal : Canny edge detection. Hysteresis is done with a union-find over the candidate pixels instead
+//         of a recursive flood fill : memory is one label per pixel and the call stack never grows, so
+//         it works on very large images. Bands of rows are labeled in parallel, then stitched together.
+//  Authors : Amel Boulhamane and Tom Hausmann
+// 
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments 
+//
+// --------------------------------------------------------
+
+
+#define NOT_EDGE 0
+#define WEAK 1
+#define STRONG 2
+
+
+/// @brief Finds the root of a set, halving the path on the way.
+static uint32_t findRoot(uint32_t *parent, uint32_t i) {
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+
+/// @brief Merges two sets, the smallest index becomes the root.
+static void unite(uint32_t *parent, uint32_t a, uint32_t b) {
+    a = findRoot(parent, a);
+    b = findRoot(parent, b);
+    if (a < b) parent[b] = a;
+    else if (b < a) parent[a] = b;
+}
+
+
+/// @brief Non-maximum suppression and double threshold : keeps the pixels that are a local maximum
+/// along their gradient direction and classifies them as WEAK or STRONG.
+static void suppressAndClassify(const uint16_t *mag, const uint8_t *dir, uint8_t *cls, int w, int h, int low, int high) {
+    // Neighbour offsets along each quantized direction (y axis pointing down)
+    static const int ddx[4] = {1, 1, 0, 1};
+    static const int ddy[4] = {0, 1, 1, -1};
+
+    #pragma omp parallel for
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            size_t i = (size_t)y * w + x;
+            int m = mag[i];
+            cls[i] = NOT_EDGE;
+            if (m < low) continue;
+
+            int dx = ddx[dir[i]], dy = ddy[dir[i]];
+            int xa = x + dx, ya = y + dy, xb = x - dx, yb = y - dy;
+            int ma = (xa >= 0 && xa < w && ya >= 0 && ya < h) ? mag[(size_t)ya * w + xa] : 0;
+            int mb = (xb >= 0 && xb < w && yb >= 0 && yb < h) ? mag[(size_t)yb * w + xb] : 0;
+
+            // Strict on one side only, so plateaus keep exactly one pixel
+            if (m > ma && m >= mb) {
+                cls[i] = (m >= high) ? STRONG : WEAK;
+            }
+        }
+    }
+}
+
+
+/// @brief Hysteresis : a candidate pixel is an edge when its 8-connected component holds a STRONG pixel.
+/// @param cls Classes from suppressAndClassify, replaced by 255 (edge) / 0.
+/// @return 0 on success, -1 on error.
+static int hysteresis(uint8_t *cls, int w, int h) {
+    size_t n = (size_t)w * h;
+    uint32_t *parent = (uint32_t *)malloc(n * sizeof(uint32_t));
+    uint8_t *strongRoot = (uint8_t *)calloc(n, 1);
+    if (!parent || !strongRoot) {
+        free(parent);
+        free(strongRoot);
+        return -1;
+    }
+
+    int bands = 1;
+#ifdef _OPENMP
+    bands = omp_get_max_threads();
+#endif
+    if (bands > h) bands = h;
+    int bandHeight = (h + bands - 1) / bands;
+
+    // 1) Label each band on its own : links to the left and upper neighbours of the same band
+    #pragma omp parallel for
+    for (int b = 0; b < bands; b++) {
+        int y0 = b * bandHeight, y1 = y0 + bandHeight > h ? h : y0 + bandHeight;
+        for (int y = y0; y < y1; y++) {
+            for (int x = 0; x < w; x++) {
+                uint32_t i = (uint32_t)((size_t)y * w + x);
+                parent[i] = i;
+                if (!cls[i]) continue;
+
+                if (x > 0 && cls[i - 1]) unite(parent, i, i - 1);
+                if (y > y0) {
+                    uint32_t up = i - w;
+                    if (cls[up]) unite(parent, i, up);
+                    if (x > 0 && cls[up - 1]) unite(parent, i, up - 1);
+                    if (x < w - 1 && cls[up + 1]) unite(parent, i, up + 1);
+                }
+            }
+        }
+    }
+
+    // 2) Stitch the first row of every band to the last row of the band above
+    for (int b = 1; b < bands; b++) {
+        int y = b * bandHeight;
+        if (y >= h) break;
+        for (int x = 0; x < w; x++) {
+            uint32_t i = (uint32_t)((size_t)y * w + x), up = i - w;
+            if (!cls[i]) continue;
+            if (cls[up]) unite(parent, i, up);
+            if (x > 0 && cls[up - 1]) unite(parent, i, up - 1);
+            if (x < w - 1 && cls[up + 1]) unite(parent, i, up + 1);
+        }
+    }
+
+    // 3) Flag the components holding a strong pixel, then keep their pixels
+    for (size_t i = 0; i < n; i++) {
+        if (cls[i] == STRONG) strongRoot[findRoot(parent, (uint32_t)i)] = 1;
+    }
+    for (size_t i = 0; i < n; i++) {
+        cls[i] = (cls[i] && strongRoot[findRoot(parent, (uint32_t)i)]) ? 255 : 0;
+    }
+
+    free(parent);
+    free(strongRoot);
+    return 0;
+}
+
+
+/// @brief Runs the steps after the gradient and writes the edges into a new 8-bit image.
+static t_bmp8 *cannyFromField(const uint16_t *mag, const uint8_t *dir, int w, int h, int low, int high) {
+    uint8_t *cls = (uint8_t *)malloc((size_t)w * h);
+    if (!cls) return NULL;
+
+    // Sobel magnitudes are 4 times the 0-255 scale
+    suppressAndClassify(mag, dir, cls, w, h, low * 4, high * 4);
+    t_bmp8 *out = NULL;
+    if (hysteresis(cls, w, h) == 0) {
+        out = bmp8_allocate(w, h);
+    }
+
+    t_plane dst = {0};
+    if (out && plane_fromBmp8(out, &dst) == 0) {
+        for (int y = 0; y < h; y++) {
+            for (int x = 0; x < w; x++) {
+                dst.rows[y][x] = cls[(size_t)y * w + x];
+            }
+        }
+    }
+    plane_free(&dst);
+    free(cls);
+    return out;
+}
+
+
+/// @brief Allocates the magnitude and direction arrays of a gradient field.
+static int allocateField(int w, int h, uint16_t **mag, uint8_t **dir) {
+    size_t n = (size_t)w * h;
+    if (n >= UINT32_MAX) {
+        fprintf(stderr, "Image too large for edge detection.\n");
+        return -1;
+    }
+    *mag = (uint16_t *)malloc(n * sizeof(uint16_t));
+    *dir = (uint8_t *)malloc(n);
+    if (!*mag || !*dir) {
+        fprintf(stderr, "Memory allocation failed for edge detection.\n");
+        free(*mag);
+        free(*dir);
+        return -1;
+    }
+    return 0;
+}
+
+
+/// @brief Detects the edges of an 8-bit image with the Canny method.
+/// @param img 8-bit image (not modified).
+/// @param low Low threshold (0-255 scale).
+/// @param high High threshold (0-255 scale).
+/// @return A new black and white image with the edges in white, or NULL on error.
+t_bmp8 *bmp8_canny(t_bmp8 *img, int low, int high) {
+    if (!img || !img->data) return NULL;
+
+    uint16_t *mag;
+    uint8_t *dir;
+    if (allocateField(img->width, img->height, &mag, &dir) != 0) return NULL;
+
+    // Gaussian smoothing with the shared 3x3 convolution, on a copy
+    t_bmp8 *smooth = bmp8_copy(img);
+    t_bmp8 *out = NULL;
+    if (smooth) {
+        bmp8_gaussianBlur(smooth);
+
+        if (bmp8_gradientField(smooth, GRADIENT_SOBEL, GRADIENT_L2, mag, dir) == 0) {
+            out = cannyFromField(mag, dir, img->width, img->height, low, high);
+        }
+        bmp8_free(smooth);
+    }
+
+    free(mag);
+    free(dir);
+    return out;
+}
+
+
+/// @brief Detects the edges of a 24-bit image (on its luminance) with the Canny method.
+/// @param img 24-bit image (not modified).
+/// @param low Low threshold (0-255 scale).
+/// @param high High threshold (0-255 scale).
+/// @return A new black and white 8-bit image with the edges in white, or NULL on error.
+t_bmp8 *bmp24_canny(t_bmp24 *img, int low, int high) {
+    if (!img) return NULL;
+
+    uint16_t *mag;
+    uint8_t *dir;
+    if (allocateField(img->width, img->height, &mag, &dir) != 0) return NULL;
+
+    t_bmp24 *smooth = bmp24_copy(img);
+    t_bmp8 *out = NULL;
+    if (smooth) {
+        bmp24_gaussianBlur(smooth);
+        if (bmp24_gradientField(smooth, GRADIENT_SOBEL, GRADIENT_L2, mag, dir) == 0) {
+            out = cannyFromField(mag, dir, img->width, img->height, low, high);
+        }
+        bmp24_free(smooth);
+    }
+
+    free(mag);
+    free(dir);
+    return out;
+}
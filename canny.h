@@ -0,0 +1,23 @@
+#ifndef CANNY_H
+#define CANNY_H
+
+#include "bmp8.h"
+#include "bmp24.h"
+
+// -------------------- HEADER ---------------------------
+//  Name : canny.h
+//  Goal : Canny edge detector (smoothing, gradient, non-maximum suppression, hysteresis)
+//  Authors : Amel Boulhamane and Tom Hausmann
+// 
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments 
+//
+// --------------------------------------------------------
+
+
+// Thresholds are on the 0-255 scale of bmp8_gradient : pixels above high are edges, pixels between
+// low and high are edges only when they are connected to a pixel above high.
+// The result is a new black and white image (edges = 255).
+t_bmp8 *bmp8_canny(t_bmp8 *img, int low, int high);
+t_bmp8 *bmp24_canny(t_bmp24 *img, int low, int high);
+
+#endif // CANNY_H
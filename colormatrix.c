@@ -0,0 +1,201 @@
+#include "colormatrix.h"
+#include "image.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+// -------------------- HEADER ---------------------------
+//  Name : colormatrix.c
+//  Goal : 3x3 color matrices plus offset on (red, green, blue) : sepia, channel mixing, saturation,
+//         white balance and YUV / YCbCr conversions, composed first and applied in a single pass
+//  Authors : Amel Boulhamane and Tom Hausmann
+//
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments
+//
+// --------------------------------------------------------
+
+
+const t_color_matrix COLOR_RGB_TO_YUV = {
+    {{ 0.299f,    0.587f,    0.114f},
+     {-0.14713f, -0.28886f,  0.436f},
+     { 0.615f,   -0.51499f, -0.10001f}},
+    {0.0f, 0.0f, 0.0f}
+};
+
+const t_color_matrix COLOR_YUV_TO_RGB = {
+    {{1.0f,  0.0f,      1.13983f},
+     {1.0f, -0.39465f, -0.58060f},
+     {1.0f,  2.03211f,  0.0f}},
+    {0.0f, 0.0f, 0.0f}
+};
+
+const t_color_matrix COLOR_RGB_TO_YCBCR = {
+    {{ 0.299f,     0.587f,     0.114f},
+     {-0.168736f, -0.331264f,  0.5f},
+     { 0.5f,      -0.418688f, -0.081312f}},
+    {0.0f, 128.0f, 128.0f}
+};
+
+const t_color_matrix COLOR_YCBCR_TO_RGB = {
+    {{1.0f,  0.0f,       1.402f},
+     {1.0f, -0.344136f, -0.714136f},
+     {1.0f,  1.772f,     0.0f}},
+    {-1.402f * 128.0f, (0.344136f + 0.714136f) * 128.0f, -1.772f * 128.0f}
+};
+
+// The matrix is applied in fixed point with 14 fractional bits. Coefficients up to 64 and offsets up
+// to 4096 keep every sum inside 32 bits.
+#define COLOR_FRACTION_BITS 14
+#define COLOR_MAX_COEFFICIENT 64.0f
+#define COLOR_MAX_OFFSET 4096.0f
+
+
+/// @brief Sets a matrix to the identity (no change).
+/// @param m Matrix to set.
+void color_identity(t_color_matrix *m) {
+    memset(m, 0, sizeof(*m));
+    for (int i = 0; i < 3; i++) m->m[i][i] = 1.0f;
+}
+
+
+/// @brief Composes two matrices : applying result is the same as applying first, then then, without
+/// rounding or clamping in between. result may be one of the inputs.
+/// @param first Matrix applied first.
+/// @param then Matrix applied second.
+/// @param result Receives the composed matrix.
+void color_compose(const t_color_matrix *first, const t_color_matrix *then, t_color_matrix *result) {
+    t_color_matrix r;
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            r.m[i][j] = 0.0f;
+            for (int k = 0; k < 3; k++) r.m[i][j] += then->m[i][k] * first->m[k][j];
+        }
+        r.offset[i] = then->offset[i];
+        for (int k = 0; k < 3; k++) r.offset[i] += then->m[i][k] * first->offset[k];
+    }
+    *result = r;
+}
+
+
+/// @brief Sets a matrix writing the gray level of each pixel into its three channels.
+/// @param m Matrix to set.
+/// @param weights GRAY_AVERAGE, GRAY_BT601 or GRAY_BT709 (the average is rounded, where
+/// bmp24_grayscale truncates).
+void color_grayscale(t_color_matrix *m, t_gray_weights weights) {
+    float w[3] = {1.0f / 3, 1.0f / 3, 1.0f / 3};
+    if (weights == GRAY_BT601) {
+        w[0] = 0.299f; w[1] = 0.587f; w[2] = 0.114f;
+    } else if (weights == GRAY_BT709) {
+        w[0] = 0.2126f; w[1] = 0.7152f; w[2] = 0.0722f;
+    }
+    memset(m, 0, sizeof(*m));
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) m->m[i][j] = w[j];
+    }
+}
+
+
+/// @brief Sets the classic sepia toning matrix.
+/// @param m Matrix to set.
+void color_sepia(t_color_matrix *m) {
+    static const float sepia[3][3] = {
+        {0.393f, 0.769f, 0.189f},
+        {0.349f, 0.686f, 0.168f},
+        {0.272f, 0.534f, 0.131f}
+    };
+    color_mix(m, sepia);
+}
+
+
+/// @brief Sets a saturation matrix, mixing each pixel with its BT.601 gray level.
+/// @param m Matrix to set.
+/// @param amount 0 gives gray, 1 leaves the colors unchanged, above 1 saturates.
+void color_saturation(t_color_matrix *m, float amount) {
+    color_grayscale(m, GRAY_BT601);
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            m->m[i][j] = (1.0f - amount) * m->m[i][j] + (i == j ? amount : 0.0f);
+        }
+    }
+}
+
+
+/// @brief Sets a white balance matrix, multiplying each channel by its own gain.
+/// @param m Matrix to set.
+/// @param red @param green @param blue Gains of the channels (1 leaves a channel unchanged).
+void color_gains(t_color_matrix *m, float red, float green, float blue) {
+    memset(m, 0, sizeof(*m));
+    m->m[0][0] = red;
+    m->m[1][1] = green;
+    m->m[2][2] = blue;
+}
+
+
+/// @brief Sets a channel mixing matrix, without offset.
+/// @param m Matrix to set.
+/// @param mix mix[i][j] is the weight of input channel j in output channel i (red, green, blue order).
+void color_mix(t_color_matrix *m, const float mix[3][3]) {
+    memcpy(m->m, mix, sizeof(m->m));
+    for (int i = 0; i < 3; i++) m->offset[i] = 0.0f;
+}
+
+
+/// @brief Applies fixed-point coefficients to one row given as three sample arrays with the same step.
+static void matrixRow(uint8_t *r, uint8_t *g, uint8_t *b, int step, int width, int32_t c[3][4]) {
+    const int32_t max = 255 << COLOR_FRACTION_BITS;
+
+    #pragma omp simd
+    for (int x = 0; x < width; x++) {
+        int32_t rr = r[x * step], gg = g[x * step], bb = b[x * step];
+        int32_t v0 = c[0][0] * rr + c[0][1] * gg + c[0][2] * bb + c[0][3];
+        int32_t v1 = c[1][0] * rr + c[1][1] * gg + c[1][2] * bb + c[1][3];
+        int32_t v2 = c[2][0] * rr + c[2][1] * gg + c[2][2] * bb + c[2][3];
+        v0 = v0 < 0 ? 0 : (v0 > max ? max : v0);
+        v1 = v1 < 0 ? 0 : (v1 > max ? max : v1);
+        v2 = v2 < 0 ? 0 : (v2 > max ? max : v2);
+        r[x * step] = (uint8_t)(v0 >> COLOR_FRACTION_BITS);
+        g[x * step] = (uint8_t)(v1 >> COLOR_FRACTION_BITS);
+        b[x * step] = (uint8_t)(v2 >> COLOR_FRACTION_BITS);
+    }
+}
+
+
+/// @brief Applies a color matrix to every pixel of a 24-bit image (any layout), in one pass. The results
+/// are rounded and clamped to [0, 255] ; the alpha of BGRA pixels is left untouched.
+/// @param img Image to modify.
+/// @param m Matrix to apply, usually composed from several adjustments with color_compose.
+/// @return 0 on success, -1 on error (coefficients beyond +-64 or offsets beyond +-4096).
+int bmp24_colorMatrix(t_bmp24 *img, const t_color_matrix *m) {
+    if (!img || !m) return -1;
+
+    // Coefficients in fixed point, the offset column also carries the rounding of the shift
+    int32_t c[3][4];
+    float one = (float)(1 << COLOR_FRACTION_BITS);
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            if (fabsf(m->m[i][j]) > COLOR_MAX_COEFFICIENT) {
+                fprintf(stderr, "Error: color matrix coefficient %f out of range\n", m->m[i][j]);
+                return -1;
+            }
+            c[i][j] = (int32_t)lroundf(m->m[i][j] * one);
+        }
+        if (fabsf(m->offset[i]) > COLOR_MAX_OFFSET) {
+            fprintf(stderr, "Error: color matrix offset %f out of range\n", m->offset[i]);
+            return -1;
+        }
+        c[i][3] = (int32_t)lroundf(m->offset[i] * one) + (1 << (COLOR_FRACTION_BITS - 1));
+    }
+
+    t_image view;
+    if (image_fromBmp24(img, &view) != 0) return -1;
+
+    #pragma omp parallel for
+    for (int y = 0; y < view.height; y++) {
+        uint8_t *rgb[3];
+        int step = image_rgbRow(&view, y, rgb);
+        matrixRow(rgb[0], rgb[1], rgb[2], step, view.width, c);
+    }
+    image_free(&view);
+    return 0;
+}
@@ -0,0 +1,52 @@
+#ifndef COLORMATRIX_H
+#define COLORMATRIX_H
+
+#include "bmp24.h"
+#include "gray.h"
+
+// -------------------- HEADER ---------------------------
+//  Name : colormatrix.h
+//  Goal : 3x3 color matrices plus offset on (red, green, blue) : sepia, channel mixing, saturation,
+//         white balance and YUV / YCbCr conversions, composed first and applied in a single pass
+//  Authors : Amel Boulhamane and Tom Hausmann
+//
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments
+//
+// --------------------------------------------------------
+
+
+// out[i] = m[i][0] * red + m[i][1] * green + m[i][2] * blue + offset[i], with samples in [0, 255]
+typedef struct {
+    float m[3][3];
+    float offset[3];
+} t_color_matrix;
+
+// Conversions used by the equalization (YUV, U and V centered on 0) and by JPEG (YCbCr, full range)
+extern const t_color_matrix COLOR_RGB_TO_YUV;
+extern const t_color_matrix COLOR_YUV_TO_RGB;
+extern const t_color_matrix COLOR_RGB_TO_YCBCR;
+extern const t_color_matrix COLOR_YCBCR_TO_RGB;
+
+void color_identity(t_color_matrix *m);
+void color_compose(const t_color_matrix *first, const t_color_matrix *then, t_color_matrix *result);
+void color_grayscale(t_color_matrix *m, t_gray_weights weights);
+void color_sepia(t_color_matrix *m);
+void color_saturation(t_color_matrix *m, float amount);
+void color_gains(t_color_matrix *m, float red, float green, float blue);
+void color_mix(t_color_matrix *m, const float mix[3][3]);
+
+int bmp24_colorMatrix(t_bmp24 *img, const t_color_matrix *m);
+
+
+/// @brief Applies a matrix to one color in float, without rounding or clamping. Inline, as the
+/// equalization calls it twice per pixel.
+/// @param m Matrix to apply.
+/// @param in Input color (red, green, blue for the RGB matrices).
+/// @param out Output color, must not overlap in.
+static inline void color_applyFloat(const t_color_matrix *m, const float in[3], float out[3]) {
+    for (int i = 0; i < 3; i++) {
+        out[i] = m->m[i][0] * in[0] + m->m[i][1] * in[1] + m->m[i][2] * in[2] + m->offset[i];
+    }
+}
+
+#endif // COLORMATRIX_H
@@ -1,5 +1,7 @@
 // equalize24.c
 #include "equalize24.h"
+#include "plane.h"
+#include "colormatrix.h"
 #include <stdlib.h>
 #include <math.h>
 
@@ -23,9 +25,11 @@
 static void rgb2yuv(uint8_t R, uint8_t G, uint8_t B,
                     float *Y, float *U, float *V)
 {
-    *Y =  0.299f * R + 0.587f * G + 0.114f * B;
-    *U = -0.14713f * R - 0.28886f * G + 0.436f * B;
-    *V =  0.615f * R - 0.51499f * G - 0.10001f * B;
+    float rgb[3] = {R, G, B}, yuv[3];
+    color_applyFloat(&COLOR_RGB_TO_YUV, rgb, yuv);
+    *Y = yuv[0];
+    *U = yuv[1];
+    *V = yuv[2];
 }
 
 // Inverse conversion
@@ -39,74 +43,99 @@ static void rgb2yuv(uint8_t R, uint8_t G, uint8_t B,
 static void yuv2rgb(float Y, float U, float V,
                     uint8_t *R, uint8_t *G, uint8_t *B)
 {
-    int r = (int)roundf(Y + 1.13983f * V);
-    int g = (int)roundf(Y - 0.39465f * U - 0.58060f * V);
-    int b = (int)roundf(Y + 2.03211f * U);
+    float yuv[3] = {Y, U, V}, rgb[3];
+    color_applyFloat(&COLOR_YUV_TO_RGB, yuv, rgb);
+    int r = (int)roundf(rgb[0]);
+    int g = (int)roundf(rgb[1]);
+    int b = (int)roundf(rgb[2]);
 
     *R = (uint8_t)(r < 0 ? 0 : (r > 255 ? 255 : r));
     *G = (uint8_t)(g < 0 ? 0 : (g > 255 ? 255 : g));
     *B = (uint8_t)(b < 0 ? 0 : (b > 255 ? 255 : b));
 }
 
-/// @brief Applies histogram equalization to 24-bit color image using YUV color space.
-/// @param img Pointer to 24-bit BMP image to equalize.
-void bmp24_equalize(t_bmp24 *img) {
-    if (!img || !img->data) return;
-
-    int w = img->width, h = img->height;
-    int N = w * h;
-
-    // 1) Helps build histogram for the Y channel
-    unsigned int *hist = calloc(256, sizeof(unsigned int));
-    if (!hist) return;
+/// @brief Gives the histogram bin of a pixel : its luminance Y, rounded and clamped to [0, 255].
+/// @param R @param G @param B Color of the pixel.
+/// @return The bin, 0 to 255.
+int bmp24_lumaIndex(uint8_t R, uint8_t G, uint8_t B) {
+    float Yf, Uf, Vf;
+    rgb2yuv(R, G, B, &Yf, &Uf, &Vf);
+    int Yi = (int)roundf(Yf);
+    if (Yi < 0) Yi = 0; else if (Yi > 255) Yi = 255;
+    return Yi;
+}
 
-    for (int y = 0; y < h; y++) {
-        for (int x = 0; x < w; x++) {
-            t_pixel p = img->data[y][x];
-            float Yf, Uf, Vf;
-            rgb2yuv(p.red, p.green, p.blue, &Yf, &Uf, &Vf);
-            int Yi = (int)roundf(Yf);
-            if (Yi < 0) Yi = 0; else if (Yi > 255) Yi = 255;
-            hist[Yi]++;
-        }
-    }
 
-    // 2) Computation of the CDF
-    unsigned int *cdf = calloc(256, sizeof(unsigned int));
-    if (!cdf) { free(hist); return; }
+/// @brief Builds the lookup table mapping each luminance to its equalized value.
+/// @param hist Histogram of the luminance (256 bins).
+/// @param totalPixels Number of pixels counted in the histogram.
+/// @param map Receives the 256 equalized values.
+void bmp24_computeEqualizeMap(const unsigned int *hist, unsigned int totalPixels, uint8_t map[256]) {
+    unsigned int cdf[256];
     cdf[0] = hist[0];
     for (int i = 1; i < 256; i++) {
         cdf[i] = cdf[i - 1] + hist[i];
     }
+
     // Finding the non 0 minimum
     unsigned int cdf_min = 0;
     for (int i = 0; i < 256; i++) {
         if (cdf[i] > 0) { cdf_min = cdf[i]; break; }
     }
 
-    // 3) Build lookup table
-    uint8_t map[256];
     for (int i = 0; i < 256; i++) {
-        map[i] = (uint8_t)roundf(((float)(cdf[i] - cdf_min) / (float)(N - cdf_min)) * 255.0f);
+        map[i] = (uint8_t)roundf(((float)(cdf[i] - cdf_min) / (float)(totalPixels - cdf_min)) * 255.0f);
+    }
+}
+
+
+/// @brief Replaces the luminance of a pixel by its equalized value, keeping U and V.
+/// @param R @param G @param B Color of the pixel, modified in place.
+/// @param map Lookup table from bmp24_computeEqualizeMap.
+void bmp24_equalizePixel(uint8_t *R, uint8_t *G, uint8_t *B, const uint8_t map[256]) {
+    float Yf, Uf, Vf;
+    rgb2yuv(*R, *G, *B, &Yf, &Uf, &Vf);
+    int Yi = (int)roundf(Yf);
+    if (Yi < 0) Yi = 0; else if (Yi > 255) Yi = 255;
+    yuv2rgb(map[Yi], Uf, Vf, R, G, B);
+}
+
+
+/// @brief Applies histogram equalization to 24-bit color image using YUV color space.
+/// @param img Pointer to 24-bit BMP image to equalize.
+void bmp24_equalize(t_bmp24 *img) {
+    if (!img) return;
+
+    int w = img->width, h = img->height;
+    int N = w * h;
+
+    // Channel views, so every layout is handled
+    t_plane R, G, B;
+    if (plane_fromBmp24(img, PLANE_RED, &R) != 0) return;
+    if (plane_fromBmp24(img, PLANE_GREEN, &G) != 0) { plane_free(&R); return; }
+    if (plane_fromBmp24(img, PLANE_BLUE, &B) != 0) { plane_free(&R); plane_free(&G); return; }
+    int step = R.step;
+
+    // 1) Helps build histogram for the Y channel
+    unsigned int hist[256] = {0};
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            hist[bmp24_lumaIndex(R.rows[y][x * step], G.rows[y][x * step], B.rows[y][x * step])]++;
+        }
     }
 
-    // 4) Mapping back to the image
+    // 2) Computation of the CDF and of the lookup table
+    uint8_t map[256];
+    bmp24_computeEqualizeMap(hist, N, map);
+
+    // 3) Mapping back to the image, while keeping the U/V replacing the Y with the equalized Y
     for (int y = 0; y < h; y++) {
         for (int x = 0; x < w; x++) {
-            t_pixel p = img->data[y][x];
-            float Yf, Uf, Vf;
-            rgb2yuv(p.red, p.green, p.blue, &Yf, &Uf, &Vf);
-            int Yi = (int)roundf(Yf);
-            if (Yi < 0) Yi = 0; else if (Yi > 255) Yi = 255;
-
-            // While keeping the U/V replacing the Y with the equalized Y
-            yuv2rgb(map[Yi], Uf, Vf,
-                     &img->data[y][x].red,
-                     &img->data[y][x].green,
-                     &img->data[y][x].blue);
+            bmp24_equalizePixel(&R.rows[y][x * step], &G.rows[y][x * step], &B.rows[y][x * step], map);
         }
     }
 
-    free(hist);
-    free(cdf);
+    plane_free(&R);
+    plane_free(&G);
+    plane_free(&B);
 }
@@ -8,5 +8,10 @@
 // This will boost contrast while preserving color.
 void bmp24_equalize(t_bmp24 *img);
 
+// Building blocks of the equalization, also used by the streaming pipeline
+int bmp24_lumaIndex(uint8_t R, uint8_t G, uint8_t B);
+void bmp24_computeEqualizeMap(const unsigned int *hist, unsigned int totalPixels, uint8_t map[256]);
+void bmp24_equalizePixel(uint8_t *R, uint8_t *G, uint8_t *B, const uint8_t map[256]);
+
 #endif // EQUALIZE24_H
 
@@ -23,8 +23,12 @@ unsigned int *bmp8_computeHistogram(t_bmp8 *img) {
     unsigned int *hist = calloc(256, sizeof(unsigned int));
     if (!hist) return NULL;
 
-    for (unsigned int i = 0; i < img->dataSize; i++) {
-        hist[img->data[i]]++;
+    // Padding bytes at the end of the rows are not pixels
+    for (unsigned int y = 0; y < img->height; y++) {
+        const unsigned char *row = img->data + (size_t)y * img->stride;
+        for (unsigned int x = 0; x < img->width; x++) {
+            hist[row[x]]++;
+        }
     }
 
     return hist;
@@ -78,8 +82,11 @@ void bmp8_equalize(t_bmp8 *img) {
         return;
     }
 
-    for (unsigned int i = 0; i < img->dataSize; i++) {
-        img->data[i] = (unsigned char)cdf[img->data[i]];
+    for (unsigned int y = 0; y < img->height; y++) {
+        unsigned char *row = img->data + (size_t)y * img->stride;
+        for (unsigned int x = 0; x < img->width; x++) {
+            row[x] = (unsigned char)cdf[row[x]];
+        }
     }
 
     free(hist);
@@ -0,0 +1,231 @@
+#include "gradient.h"
+#include "plane.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// -------------------- HEADER ---------------------------
+//  Name : gradient.c
+//  Goal : compute Sobel / Scharr gradients in one pass. Three luminance rows are kept in a ring, and
+//         Gx, Gy, the magnitude and the orientation of a whole row are computed with integer loops
+//         the compiler vectorizes.
+//  Authors : Amel Boulhamane and Tom Hausmann
+// 
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments 
+//
+// --------------------------------------------------------
+
+
+// Source of the luminance rows : either a gray plane or a 24-bit image converted on the fly
+typedef struct {
+    t_bmp24 *img24;
+    t_plane plane;
+    int width;
+    int height;
+} t_source;
+
+
+/// @brief Loads row y (clamped to the image) as luminance into out[1..width], and replicates the edge
+/// pixels into out[0] and out[width + 1]. Colors use the BT.601 weights in 8.8 fixed point.
+static void lumaRow(const t_source *src, int y, int16_t *out) {
+    int w = src->width;
+    y = y < 0 ? 0 : (y >= src->height ? src->height - 1 : y);
+
+    if (src->img24 && src->img24->layout == BMP24_PLANAR) {
+        size_t offset = (size_t)y * src->img24->planeStride;
+        const uint8_t *r = src->img24->planes[0] + offset;
+        const uint8_t *g = src->img24->planes[1] + offset;
+        const uint8_t *b = src->img24->planes[2] + offset;
+        for (int x = 0; x < w; x++) {
+            out[x + 1] = (int16_t)((77 * r[x] + 150 * g[x] + 29 * b[x] + 128) >> 8);
+        }
+    } else if (src->img24 && src->img24->layout == BMP24_BGRA) {
+        const uint8_t *p = src->img24->bgra + (size_t)y * src->img24->bgraStride;
+        for (int x = 0; x < w; x++) {
+            out[x + 1] = (int16_t)((77 * p[4 * x + 2] + 150 * p[4 * x + 1] + 29 * p[4 * x] + 128) >> 8);
+        }
+    } else if (src->img24) {
+        const t_pixel *row = src->img24->data[y];
+        for (int x = 0; x < w; x++) {
+            out[x + 1] = (int16_t)((77 * row[x].red + 150 * row[x].green + 29 * row[x].blue + 128) >> 8);
+        }
+    } else {
+        const uint8_t *row = src->plane.rows[y];
+        for (int x = 0; x < w; x++) {
+            out[x + 1] = row[x * src->plane.step];
+        }
+    }
+    out[0] = out[1];
+    out[w + 1] = out[w];
+}
+
+
+/// @brief Runs the gradient over the whole source. Every output is optional.
+/// @param magnitude Full precision magnitudes (width x height).
+/// @param magnitude8 Rows of an 8-bit image receiving the scaled magnitude.
+/// @param direction Quantized orientations (width x height).
+/// @return 0 on success, -1 on error.
+static int gradientSweep(const t_source *src, t_gradient_kernel kernel, t_gradient_norm norm,
+                         uint16_t *magnitude, uint8_t **magnitude8, uint8_t *direction) {
+    int w = src->width, h = src->height;
+    int side = (kernel == GRADIENT_SCHARR) ? 3 : 1;
+    int center = (kernel == GRADIENT_SCHARR) ? 10 : 2;
+    int shift = (kernel == GRADIENT_SCHARR) ? 4 : 2;     // brings a 255 step back to 255
+
+    int16_t *ring = (int16_t *)malloc(3 * (size_t)(w + 2) * sizeof(int16_t));
+    int32_t *gx = (int32_t *)malloc((size_t)w * sizeof(int32_t));
+    int32_t *gy = (int32_t *)malloc((size_t)w * sizeof(int32_t));
+    int32_t *mag = (int32_t *)malloc((size_t)w * sizeof(int32_t));
+    if (!ring || !gx || !gy || !mag) {
+        fprintf(stderr, "Memory allocation failed for gradient.\n");
+        free(ring); free(gx); free(gy); free(mag);
+        return -1;
+    }
+
+    int16_t *above = ring, *cur = ring + (w + 2), *below = ring + 2 * (w + 2);
+    lumaRow(src, -1, above);
+    lumaRow(src, 0, cur);
+
+    for (int y = 0; y < h; y++) {
+        lumaRow(src, y + 1, below);
+
+        for (int x = 0; x < w; x++) {
+            int dx0 = above[x + 2] - above[x], dx1 = cur[x + 2] - cur[x], dx2 = below[x + 2] - below[x];
+            int dy0 = below[x] - above[x], dy1 = below[x + 1] - above[x + 1], dy2 = below[x + 2] - above[x + 2];
+            gx[x] = side * (dx0 + dx2) + center * dx1;
+            gy[x] = side * (dy0 + dy2) + center * dy1;
+        }
+
+        for (int x = 0; x < w; x++) {
+            int ax = gx[x] < 0 ? -gx[x] : gx[x];
+            int ay = gy[x] < 0 ? -gy[x] : gy[x];
+            if (norm == GRADIENT_L1) {
+                mag[x] = ax + ay;
+            } else {
+                int hi = ax > ay ? ax : ay, lo = ax > ay ? ay : ax;
+                mag[x] = hi + ((3 * lo) >> 3);
+            }
+        }
+
+        if (magnitude) {
+            uint16_t *out = magnitude + (size_t)y * w;
+            for (int x = 0; x < w; x++) out[x] = (uint16_t)mag[x];
+        }
+        if (magnitude8) {
+            uint8_t *out = magnitude8[y];
+            for (int x = 0; x < w; x++) {
+                int v = mag[x] >> shift;
+                out[x] = (uint8_t)(v > 255 ? 255 : v);
+            }
+        }
+        if (direction) {
+            // tan(22.5) ~ 106 / 256 and tan(67.5) ~ 618 / 256
+            uint8_t *out = direction + (size_t)y * w;
+            for (int x = 0; x < w; x++) {
+                int ax = gx[x] < 0 ? -gx[x] : gx[x];
+                int ay = gy[x] < 0 ? -gy[x] : gy[x];
+                if (ay * 256 <= ax * 106) {
+                    out[x] = GRADIENT_DIR_0;
+                } else if (ay * 256 >= ax * 618) {
+                    out[x] = GRADIENT_DIR_90;
+                } else {
+                    out[x] = ((gx[x] > 0) == (gy[x] > 0)) ? GRADIENT_DIR_45 : GRADIENT_DIR_135;
+                }
+            }
+        }
+
+        // Rotate the ring
+        int16_t *tmp = above;
+        above = cur;
+        cur = below;
+        below = tmp;
+    }
+
+    free(ring); free(gx); free(gy); free(mag);
+    return 0;
+}
+
+
+/// @brief Computes the gradient field of an 8-bit image.
+/// @param img 8-bit image.
+/// @param kernel GRADIENT_SOBEL or GRADIENT_SCHARR.
+/// @param norm GRADIENT_L1 or GRADIENT_L2.
+/// @param magnitude Optional width x height array receiving the magnitudes.
+/// @param direction Optional width x height array receiving the GRADIENT_DIR_* codes.
+/// @return 0 on success, -1 on error.
+int bmp8_gradientField(t_bmp8 *img, t_gradient_kernel kernel, t_gradient_norm norm, uint16_t *magnitude, uint8_t *direction) {
+    t_source src = {0};
+    if (plane_fromBmp8(img, &src.plane) != 0) return -1;
+    src.width = src.plane.width;
+    src.height = src.plane.height;
+
+    int status = gradientSweep(&src, kernel, norm, magnitude, NULL, direction);
+    plane_free(&src.plane);
+    return status;
+}
+
+
+/// @brief Computes the gradient field of the luminance of a 24-bit image.
+/// @param img 24-bit image.
+/// @param kernel GRADIENT_SOBEL or GRADIENT_SCHARR.
+/// @param norm GRADIENT_L1 or GRADIENT_L2.
+/// @param magnitude Optional width x height array receiving the magnitudes.
+/// @param direction Optional width x height array receiving the GRADIENT_DIR_* codes.
+/// @return 0 on success, -1 on error.
+int bmp24_gradientField(t_bmp24 *img, t_gradient_kernel kernel, t_gradient_norm norm, uint16_t *magnitude, uint8_t *direction) {
+    if (!img) return -1;
+    t_source src = {0};
+    src.img24 = img;
+    src.width = img->width;
+    src.height = img->height;
+    return gradientSweep(&src, kernel, norm, magnitude, NULL, direction);
+}
+
+
+/// @brief Runs the sweep straight into the rows of a new 8-bit image.
+static t_bmp8 *gradientImage(const t_source *src, t_gradient_kernel kernel, t_gradient_norm norm, uint8_t *direction) {
+    t_bmp8 *out = bmp8_allocate(src->width, src->height);
+    if (!out) return NULL;
+
+    t_plane dst = {0};
+    if (plane_fromBmp8(out, &dst) != 0 || gradientSweep(src, kernel, norm, NULL, dst.rows, direction) != 0) {
+        plane_free(&dst);
+        bmp8_free(out);
+        return NULL;
+    }
+    plane_free(&dst);
+    return out;
+}
+
+
+/// @brief Creates the gradient magnitude image of an 8-bit image.
+/// @param img 8-bit image.
+/// @param kernel GRADIENT_SOBEL or GRADIENT_SCHARR.
+/// @param norm GRADIENT_L1 or GRADIENT_L2.
+/// @param direction Optional width x height array receiving the GRADIENT_DIR_* codes.
+/// @return The new 8-bit image, or NULL on error.
+t_bmp8 *bmp8_gradient(t_bmp8 *img, t_gradient_kernel kernel, t_gradient_norm norm, uint8_t *direction) {
+    t_source src = {0};
+    if (plane_fromBmp8(img, &src.plane) != 0) return NULL;
+    src.width = src.plane.width;
+    src.height = src.plane.height;
+
+    t_bmp8 *out = gradientImage(&src, kernel, norm, direction);
+    plane_free(&src.plane);
+    return out;
+}
+
+
+/// @brief Creates the gradient magnitude image of a 24-bit image in a single sweep (no gray copy).
+/// @param img 24-bit image.
+/// @param kernel GRADIENT_SOBEL or GRADIENT_SCHARR.
+/// @param norm GRADIENT_L1 or GRADIENT_L2.
+/// @param direction Optional width x height array receiving the GRADIENT_DIR_* codes.
+/// @return The new 8-bit image, or NULL on error.
+t_bmp8 *bmp24_gradient(t_bmp24 *img, t_gradient_kernel kernel, t_gradient_norm norm, uint8_t *direction) {
+    if (!img) return NULL;
+    t_source src = {0};
+    src.img24 = img;
+    src.width = img->width;
+    src.height = img->height;
+    return gradientImage(&src, kernel, norm, direction);
+}
@@ -0,0 +1,43 @@
+#ifndef GRADIENT_H
+#define GRADIENT_H
+
+#include <stdint.h>
+#include "bmp8.h"
+#include "bmp24.h"
+
+// -------------------- HEADER ---------------------------
+//  Name : gradient.h
+//  Goal : fused Sobel / Scharr gradient : Gx, Gy, magnitude and orientation in a single sweep
+//  Authors : Amel Boulhamane and Tom Hausmann
+// 
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments 
+//
+// --------------------------------------------------------
+
+
+typedef enum {
+    GRADIENT_SOBEL,    // weights 1 2 1
+    GRADIENT_SCHARR    // weights 3 10 3, more accurate orientation
+} t_gradient_kernel;
+
+typedef enum {
+    GRADIENT_L1,       // |Gx| + |Gy|
+    GRADIENT_L2        // sqrt(Gx^2 + Gy^2), approximated by max + 3/8 min (error < 7%)
+} t_gradient_norm;
+
+// Quantized gradient orientations (the y axis points down, row 0 is the top of the image)
+#define GRADIENT_DIR_0   0   // along x
+#define GRADIENT_DIR_45  1   // along (+x, +y)
+#define GRADIENT_DIR_90  2   // along y
+#define GRADIENT_DIR_135 3   // along (+x, -y)
+
+// Full precision field. magnitude and direction are optional (NULL) width x height arrays, top row first
+int bmp8_gradientField(t_bmp8 *img, t_gradient_kernel kernel, t_gradient_norm norm, uint16_t *magnitude, uint8_t *direction);
+int bmp24_gradientField(t_bmp24 *img, t_gradient_kernel kernel, t_gradient_norm norm, uint16_t *magnitude, uint8_t *direction);
+
+// Magnitude as a new 8-bit image (a full-contrast step edge gives 255). 24-bit images are converted
+// to luminance on the fly, row by row, without building a gray image first.
+t_bmp8 *bmp8_gradient(t_bmp8 *img, t_gradient_kernel kernel, t_gradient_norm norm, uint8_t *direction);
+t_bmp8 *bmp24_gradient(t_bmp24 *img, t_gradient_kernel kernel, t_gradient_norm norm, uint8_t *direction);
+
+#endif // GRADIENT_H
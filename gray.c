@@ -0,0 +1,78 @@
+#include "gray.h"
+#include "image.h"
+#include <stdio.h>
+#include <stdint.h>
+
+// -------------------- HEADER ---------------------------
+//  Name : gray.c
+//  Goal : convert 24-bit images straight to 8-bit grayscale images (one byte per pixel, gray color table)
+//  Authors : Amel Boulhamane and Tom Hausmann
+//
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments
+//
+// --------------------------------------------------------
+
+
+// The weighted sums are computed in 8.8 fixed point : the three weights add up to 256, so the sum of a
+// pixel fits in 16 bits and the compiler can process 8 or 16 pixels per vector instruction.
+// The average uses (sum * 21846) >> 16, which gives exactly sum / 3 for every sum up to 765.
+#define GRAY_THIRD 21846
+
+static const uint16_t grayWeights[3][3] = {
+    [GRAY_AVERAGE] = {0, 0, 0},
+    [GRAY_BT601] = {77, 150, 29},
+    [GRAY_BT709] = {54, 183, 19}
+};
+
+
+/// @brief Converts one row given as three sample arrays with the same step (planar or interleaved).
+/// @param r @param g @param b First red, green and blue samples of the row.
+/// @param step Bytes between two pixels.
+/// @param out Gray row.
+/// @param width Number of pixels.
+/// @param weights Weights of the channels.
+static void grayRow(const uint8_t *r, const uint8_t *g, const uint8_t *b, int step,
+                    uint8_t *out, int width, t_gray_weights weights) {
+    if (weights == GRAY_AVERAGE) {
+        #pragma omp simd
+        for (int x = 0; x < width; x++) {
+            uint16_t sum = (uint16_t)(r[x * step] + g[x * step] + b[x * step]);
+            out[x] = (uint8_t)(((uint32_t)sum * GRAY_THIRD) >> 16);
+        }
+        return;
+    }
+
+    const uint16_t wr = grayWeights[weights][0], wg = grayWeights[weights][1], wb = grayWeights[weights][2];
+    #pragma omp simd
+    for (int x = 0; x < width; x++) {
+        uint16_t sum = (uint16_t)(wr * r[x * step] + wg * g[x * step] + wb * b[x * step] + 128);
+        out[x] = (uint8_t)(sum >> 8);
+    }
+}
+
+
+/// @brief Converts a 24-bit image (any layout) to a new 8-bit grayscale image with a gray color table,
+/// without writing the gray level back into the three channels first.
+/// @param img Source image (left untouched).
+/// @param weights GRAY_AVERAGE, GRAY_BT601 or GRAY_BT709.
+/// @return The new 8-bit image, or NULL on error.
+t_bmp8 *bmp24_toGray8(t_bmp24 *img, t_gray_weights weights) {
+    if (!img || weights < GRAY_AVERAGE || weights > GRAY_BT709) return NULL;
+
+    t_image view;
+    if (image_fromBmp24(img, &view) != 0) return NULL;
+    t_bmp8 *out = bmp8_allocate(img->width, img->height);
+    if (!out) {
+        image_free(&view);
+        return NULL;
+    }
+
+    #pragma omp parallel for
+    for (int y = 0; y < view.height; y++) {
+        uint8_t *rgb[3];
+        int step = image_rgbRow(&view, y, rgb);
+        grayRow(rgb[0], rgb[1], rgb[2], step, bmp8_row(out, y), view.width, weights);
+    }
+    image_free(&view);
+    return out;
+}
@@ -0,0 +1,26 @@
+#ifndef GRAY_H
+#define GRAY_H
+
+#include "bmp8.h"
+#include "bmp24.h"
+
+// -------------------- HEADER ---------------------------
+//  Name : gray.h
+//  Goal : convert 24-bit images straight to 8-bit grayscale images (one byte per pixel, gray color table)
+//  Authors : Amel Boulhamane and Tom Hausmann
+//
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments
+//
+// --------------------------------------------------------
+
+
+// Weights of the red, green and blue channels in the gray level
+typedef enum {
+    GRAY_AVERAGE,   // (R + G + B) / 3, like bmp24_grayscale
+    GRAY_BT601,     // 0.299 R + 0.587 G + 0.114 B (SD video, JPEG)
+    GRAY_BT709      // 0.2126 R + 0.7152 G + 0.0722 B (HD video, sRGB)
+} t_gray_weights;
+
+t_bmp8 *bmp24_toGray8(t_bmp24 *img, t_gray_weights weights);
+
+#endif // GRAY_H
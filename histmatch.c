@@ -0,0 +1,205 @@
+#include "histmatch.h"
+#include "equalize8.h"
+#include "equalize24.h"
+#include "image.h"
+#include "plane.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// -------------------- HEADER ---------------------------
+//  Name : histmatch.c
+//  Goal : histogram matching : map the gray levels (or the luminance) of images onto a reference distribution
+//  Authors : Amel Boulhamane and Tom Hausmann
+//
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments
+//
+// --------------------------------------------------------
+//
+// A level v of the image goes to the level z of the reference with the same rank : its equalized value
+// F(v) (bmp8_computeCDF) is looked up in the inverse of the equalization G of the reference. Both are
+// folded into a single 256-entry lookup table, so an image costs one histogram pass and one LUT pass.
+
+
+/// @brief Gives the only level present in a histogram.
+/// @return The level, or -1 if the histogram holds several levels (or none).
+static int singleLevel(const unsigned int hist[256]) {
+    int level = -1;
+    for (int v = 0; v < 256; v++) {
+        if (!hist[v]) continue;
+        if (level >= 0) return -1;
+        level = v;
+    }
+    return level;
+}
+
+
+/// @brief Equalized value of every level, from bmp8_computeCDF. That function only fills the levels from
+/// the darkest one present upwards (the equalization never looks the others up) ; the levels below it
+/// are set to 0 here, as every level is looked up in a matching.
+/// @return The 256 values (to free), or NULL on error.
+static unsigned int *equalizedLevels(const unsigned int hist[256], unsigned int total) {
+    unsigned int *cdf = bmp8_computeCDF((unsigned int *)hist, total);
+    if (!cdf) return NULL;
+    for (int v = 0; v < 256 && !hist[v]; v++) cdf[v] = 0;
+    return cdf;
+}
+
+
+/// @brief Builds a reference from a histogram (e.g. a stored target distribution).
+/// @param hist Reference histogram (256 bins), at least one sample.
+/// @param target Receives the reference.
+/// @return 0 on success, -1 on error.
+int histmatch_fromHistogram(const unsigned int hist[256], t_hist_target *target) {
+    if (!hist || !target) return -1;
+
+    unsigned int total = 0;
+    for (int v = 0; v < 256; v++) total += hist[v];
+    if (total == 0) {
+        fprintf(stderr, "Error: empty reference histogram\n");
+        return -1;
+    }
+
+    // A single level : every image is mapped to it
+    int level = singleLevel(hist);
+    if (level >= 0) {
+        for (int s = 0; s < 256; s++) target->inverse[s] = (uint8_t)level;
+        return 0;
+    }
+
+    unsigned int *cdf = equalizedLevels(hist, total);
+    if (!cdf) return -1;
+
+    // The normalized CDF is non-decreasing and ends at 255, so the walk always finds a level
+    int z = 0;
+    for (int s = 0; s < 256; s++) {
+        while (z < 255 && cdf[z] < (unsigned int)s) z++;
+        target->inverse[s] = (uint8_t)z;
+    }
+    free(cdf);
+    return 0;
+}
+
+
+/// @brief Builds a reference from the gray levels of an 8-bit image.
+/// @param ref Reference image.
+/// @param target Receives the reference.
+/// @return 0 on success, -1 on error.
+int histmatch_fromBmp8(t_bmp8 *ref, t_hist_target *target) {
+    unsigned int *hist = bmp8_computeHistogram(ref);
+    if (!hist) return -1;
+    int result = histmatch_fromHistogram(hist, target);
+    free(hist);
+    return result;
+}
+
+
+/// @brief Counts the luminance levels of a 24-bit image, as bmp24_equalize does.
+/// @return 0 on success, -1 on error.
+static int lumaHistogram(t_bmp24 *img, unsigned int hist[256]) {
+    t_plane R, G, B;
+    if (plane_fromBmp24(img, PLANE_RED, &R) != 0) return -1;
+    if (plane_fromBmp24(img, PLANE_GREEN, &G) != 0) { plane_free(&R); return -1; }
+    if (plane_fromBmp24(img, PLANE_BLUE, &B) != 0) { plane_free(&R); plane_free(&G); return -1; }
+    int step = R.step;
+
+    for (int v = 0; v < 256; v++) hist[v] = 0;
+    for (int y = 0; y < img->height; y++) {
+        for (int x = 0; x < img->width; x++) {
+            hist[bmp24_lumaIndex(R.rows[y][x * step], G.rows[y][x * step], B.rows[y][x * step])]++;
+        }
+    }
+
+    plane_free(&R);
+    plane_free(&G);
+    plane_free(&B);
+    return 0;
+}
+
+
+/// @brief Builds a reference from the luminance of a 24-bit image.
+/// @param ref Reference image.
+/// @param target Receives the reference.
+/// @return 0 on success, -1 on error.
+int histmatch_fromBmp24(t_bmp24 *ref, t_hist_target *target) {
+    unsigned int hist[256];
+    if (!ref || lumaHistogram(ref, hist) != 0) return -1;
+    return histmatch_fromHistogram(hist, target);
+}
+
+
+/// @brief Builds the lookup table mapping the levels of an image onto the reference.
+/// @param hist Histogram of the image (256 bins).
+/// @param total Number of samples counted in hist.
+/// @param target Reference.
+/// @param lut Receives the 256 new values.
+/// @return 0 on success, -1 on error.
+int histmatch_computeLut(const unsigned int hist[256], unsigned int total, const t_hist_target *target, uint8_t lut[256]) {
+    if (!hist || !target || total == 0) return -1;
+
+    // A flat image has no ranks to match : it goes to the median of the reference
+    int level = singleLevel(hist);
+    if (level >= 0) {
+        for (int v = 0; v < 256; v++) lut[v] = target->inverse[128];
+        return 0;
+    }
+
+    unsigned int *cdf = equalizedLevels(hist, total);
+    if (!cdf) return -1;
+    for (int v = 0; v < 256; v++) {
+        lut[v] = target->inverse[cdf[v]];
+    }
+    free(cdf);
+    return 0;
+}
+
+
+/// @brief Maps the gray levels of an 8-bit image onto a reference distribution.
+/// @param img Image to modify.
+/// @param target Reference, from histmatch_fromBmp8, histmatch_fromBmp24 or histmatch_fromHistogram.
+/// @return 0 on success, -1 on error.
+int bmp8_matchHistogram(t_bmp8 *img, const t_hist_target *target) {
+    unsigned int *hist = bmp8_computeHistogram(img);
+    if (!hist) return -1;
+
+    uint8_t lut[256];
+    int result = histmatch_computeLut(hist, img->width * img->height, target, lut);
+    free(hist);
+    if (result != 0) return -1;
+
+    t_image view;
+    if (image_fromBmp8(img, &view) != 0) return -1;
+    image_applyLut(&view, lut);
+    image_free(&view);
+    return 0;
+}
+
+
+/// @brief Maps the luminance of a 24-bit image onto a reference distribution, keeping the U and V
+/// components of every pixel like bmp24_equalize.
+/// @param img Image to modify (any layout).
+/// @param target Reference, from histmatch_fromBmp8, histmatch_fromBmp24 or histmatch_fromHistogram.
+/// @return 0 on success, -1 on error.
+int bmp24_matchHistogram(t_bmp24 *img, const t_hist_target *target) {
+    unsigned int hist[256];
+    if (!img || lumaHistogram(img, hist) != 0) return -1;
+
+    uint8_t lut[256];
+    if (histmatch_computeLut(hist, (unsigned int)img->width * img->height, target, lut) != 0) return -1;
+
+    t_plane R, G, B;
+    if (plane_fromBmp24(img, PLANE_RED, &R) != 0) return -1;
+    if (plane_fromBmp24(img, PLANE_GREEN, &G) != 0) { plane_free(&R); return -1; }
+    if (plane_fromBmp24(img, PLANE_BLUE, &B) != 0) { plane_free(&R); plane_free(&G); return -1; }
+    int step = R.step;
+
+    for (int y = 0; y < img->height; y++) {
+        for (int x = 0; x < img->width; x++) {
+            bmp24_equalizePixel(&R.rows[y][x * step], &G.rows[y][x * step], &B.rows[y][x * step], lut);
+        }
+    }
+
+    plane_free(&R);
+    plane_free(&G);
+    plane_free(&B);
+    return 0;
+}
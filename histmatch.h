@@ -0,0 +1,30 @@
+#ifndef HISTMATCH_H
+#define HISTMATCH_H
+
+#include <stdint.h>
+#include "bmp8.h"
+#include "bmp24.h"
+
+// -------------------- HEADER ---------------------------
+//  Name : histmatch.h
+//  Goal : histogram matching : map the gray levels (or the luminance) of images onto a reference distribution
+//  Authors : Amel Boulhamane and Tom Hausmann
+//
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments
+//
+// --------------------------------------------------------
+
+
+// Reference distribution, computed once and reused for any number of images
+typedef struct {
+    uint8_t inverse[256];   // inverse[s] : smallest level whose equalized value (normalized CDF) is >= s
+} t_hist_target;
+
+int histmatch_fromHistogram(const unsigned int hist[256], t_hist_target *target);
+int histmatch_fromBmp8(t_bmp8 *ref, t_hist_target *target);
+int histmatch_fromBmp24(t_bmp24 *ref, t_hist_target *target);
+int histmatch_computeLut(const unsigned int hist[256], unsigned int total, const t_hist_target *target, uint8_t lut[256]);
+int bmp8_matchHistogram(t_bmp8 *img, const t_hist_target *target);
+int bmp24_matchHistogram(t_bmp24 *img, const t_hist_target *target);
+
+#endif // HISTMATCH_H
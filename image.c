@@ -0,0 +1,386 @@
+#include "image.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// -------------------- HEADER ---------------------------
+//  Name : image.c
+//  Goal : common descriptor over 8-bit and 24-bit images, so point and convolution kernels are written only once
+//  Authors : Amel Boulhamane and Tom Hausmann
+//
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments
+//
+// --------------------------------------------------------
+
+
+// Preset kernels, row by row from the top of the image
+static const float presetKernels[][9] = {
+    [IMAGE_BOX_BLUR] = {
+        1.0f / 9, 1.0f / 9, 1.0f / 9,
+        1.0f / 9, 1.0f / 9, 1.0f / 9,
+        1.0f / 9, 1.0f / 9, 1.0f / 9
+    },
+    [IMAGE_GAUSSIAN_BLUR] = {
+        1.0f / 16, 2.0f / 16, 1.0f / 16,
+        2.0f / 16, 4.0f / 16, 2.0f / 16,
+        1.0f / 16, 2.0f / 16, 1.0f / 16
+    },
+    [IMAGE_OUTLINE] = {
+        -1, -1, -1,
+        -1,  8, -1,
+        -1, -1, -1
+    },
+    [IMAGE_EMBOSS] = {
+        -2, -1, 0,
+        -1,  1, 1,
+         0,  1, 2
+    },
+    [IMAGE_SHARPEN] = {
+         0, -1,  0,
+        -1,  5, -1,
+         0, -1,  0
+    }
+};
+
+
+/// @brief Gives one of the preset 3x3 kernels.
+/// @param kernel Kernel wanted.
+/// @return 9 values, row by row from the top, or NULL for an unknown kernel.
+const float *image_presetKernel(t_image_kernel kernel) {
+    if (kernel < IMAGE_BOX_BLUR || kernel > IMAGE_SHARPEN) return NULL;
+    return presetKernels[kernel];
+}
+
+
+/// @brief Allocates the row pointer array of a descriptor.
+/// @return 0 on success, -1 if the allocation fails.
+static int allocateRows(t_image *view, t_image_format format, int groups, int width, int height,
+                        int channels, int pixelStep) {
+    view->rows = (uint8_t **)malloc((size_t)groups * height * sizeof(uint8_t *));
+    if (!view->rows) {
+        fprintf(stderr, "Memory allocation failed for image rows.\n");
+        return -1;
+    }
+    view->format = format;
+    view->groups = groups;
+    view->width = width;
+    view->height = height;
+    view->channels = channels;
+    view->pixelStep = pixelStep;
+    return 0;
+}
+
+
+/// @brief Builds a descriptor over the pixels of an 8-bit image, in place over its padded rows.
+/// @param img 8-bit image to describe.
+/// @param view Descriptor to fill, released with image_free.
+/// @return 0 on success, -1 on error.
+int image_fromBmp8(t_bmp8 *img, t_image *view) {
+    if (!img || !img->data || !view) return -1;
+    if (allocateRows(view, IMAGE_GRAY8, 1, img->width, img->height, 1, 1) != 0) return -1;
+
+    for (unsigned int y = 0; y < img->height; y++) {
+        view->rows[y] = bmp8_row(img, y);
+    }
+    return 0;
+}
+
+
+/// @brief Builds a descriptor over the pixels of a 24-bit image, whatever its layout.
+/// @param img 24-bit image to describe.
+/// @param view Descriptor to fill, released with image_free.
+/// @return 0 on success, -1 on error.
+int image_fromBmp24(t_bmp24 *img, t_image *view) {
+    if (!img || !view) return -1;
+
+    int ok;
+    if (img->layout == BMP24_PLANAR) {
+        ok = allocateRows(view, IMAGE_PLANAR24, 3, img->width, img->height, 1, 1) == 0;
+    } else if (img->layout == BMP24_BGRA) {
+        ok = allocateRows(view, IMAGE_BGRA32, 1, img->width, img->height, 3, 4) == 0;
+    } else {
+        ok = allocateRows(view, IMAGE_RGB24, 1, img->width, img->height, 3, 3) == 0;
+    }
+    if (!ok) return -1;
+
+    for (int y = 0; y < img->height; y++) {
+        if (img->layout == BMP24_PLANAR) {
+            for (int c = 0; c < 3; c++) {
+                view->rows[c * img->height + y] = img->planes[c] + (size_t)y * img->planeStride;
+            }
+        } else if (img->layout == BMP24_BGRA) {
+            view->rows[y] = img->bgra + (size_t)y * img->bgraStride;
+        } else {
+            view->rows[y] = (uint8_t *)img->data[y];
+        }
+    }
+    return 0;
+}
+
+
+/// @brief Gives the red, green and blue samples of a row of a 24-bit descriptor, whatever its format.
+/// @param view Descriptor filled by image_fromBmp24.
+/// @param y Row, 0 at the top.
+/// @param rgb Receives the first red, green and blue samples of the row.
+/// @return The number of bytes between two pixels of the row.
+int image_rgbRow(const t_image *view, int y, uint8_t *rgb[3]) {
+    if (view->format == IMAGE_PLANAR24) {
+        for (int c = 0; c < 3; c++) rgb[c] = view->rows[c * view->height + y];
+    } else if (view->format == IMAGE_BGRA32) {
+        // B, G, R, A in memory
+        uint8_t *p = view->rows[y];
+        rgb[0] = p + 2;
+        rgb[1] = p + 1;
+        rgb[2] = p;
+    } else {
+        uint8_t *p = view->rows[y];
+        rgb[0] = p;
+        rgb[1] = p + 1;
+        rgb[2] = p + 2;
+    }
+    return view->pixelStep;
+}
+
+
+/// @brief Releases the row pointer array of a descriptor (the pixels are left alone).
+/// @param view Descriptor to release.
+void image_free(t_image *view) {
+    if (!view) return;
+    free(view->rows);
+    view->rows = NULL;
+}
+
+
+/// @brief Replaces every filtered sample by lut[sample].
+/// @param view Pixels to modify.
+/// @param lut New value of each of the 256 levels.
+void image_applyLut(t_image *view, const uint8_t lut[256]) {
+    if (!view || !view->rows || !lut) return;
+
+    for (int r = 0; r < view->groups * view->height; r++) {
+        uint8_t *row = view->rows[r];
+        if (view->channels == view->pixelStep) {
+            for (int i = 0; i < view->width * view->pixelStep; i++) {
+                row[i] = lut[row[i]];
+            }
+            continue;
+        }
+        for (int x = 0; x < view->width; x++) {
+            for (int c = 0; c < view->channels; c++) {
+                row[x * view->pixelStep + c] = lut[row[x * view->pixelStep + c]];
+            }
+        }
+    }
+}
+
+
+/// @brief Replaces every filtered sample by 255 - sample.
+/// @param view Pixels to modify.
+void image_negative(t_image *view) {
+    if (!view || !view->rows) return;
+
+    for (int r = 0; r < view->groups * view->height; r++) {
+        uint8_t *row = view->rows[r];
+        // Contiguous samples : a plain loop the compiler vectorizes
+        if (view->channels == view->pixelStep) {
+            for (int i = 0; i < view->width * view->pixelStep; i++) {
+                row[i] = 255 - row[i];
+            }
+            continue;
+        }
+        for (int x = 0; x < view->width; x++) {
+            for (int c = 0; c < view->channels; c++) {
+                row[x * view->pixelStep + c] = 255 - row[x * view->pixelStep + c];
+            }
+        }
+    }
+}
+
+
+/// @brief Adds a value to every filtered sample, clamped to [0, 255].
+/// @param view Pixels to modify.
+/// @param value Brightness adjustment (positive brightens, negative darkens).
+void image_brightness(t_image *view, int value) {
+    if (!view || !view->rows) return;
+
+    for (int r = 0; r < view->groups * view->height; r++) {
+        uint8_t *row = view->rows[r];
+        if (view->channels == view->pixelStep) {
+            for (int i = 0; i < view->width * view->pixelStep; i++) {
+                int v = row[i] + value;
+                row[i] = (v > 255) ? 255 : (v < 0 ? 0 : v);
+            }
+            continue;
+        }
+        for (int x = 0; x < view->width; x++) {
+            for (int c = 0; c < view->channels; c++) {
+                int v = row[x * view->pixelStep + c] + value;
+                row[x * view->pixelStep + c] = (v > 255) ? 255 : (v < 0 ? 0 : v);
+            }
+        }
+    }
+}
+
+
+/// @brief Sets every filtered sample to 255 if it is >= threshold, to 0 otherwise.
+/// @param view Pixels to modify.
+/// @param threshold Threshold level.
+void image_threshold(t_image *view, int threshold) {
+    uint8_t lut[256];
+    for (int v = 0; v < 256; v++) {
+        lut[v] = (v >= threshold) ? 255 : 0;
+    }
+    image_applyLut(view, lut);
+}
+
+
+/// @brief Brings a convolution result back to a byte.
+static inline uint8_t toByte(float acc, t_image_rounding rounding) {
+    float v = (rounding == IMAGE_ROUND) ? roundf(acc) : acc;
+    if (v <= 0.0f) return 0;
+    if (v >= 255.0f) return 255;
+    return (uint8_t)v;
+}
+
+
+/// @brief Convolution of one output sample, skipping the samples outside the image.
+/// The kernel is walked column by column (dx outer, dy inner), the order every filter of the
+/// project has always used, so the float sums and the bytes stay the same.
+static inline float convolveSample(const uint8_t *const *window, int x, int c, int width, int pixelStep,
+                                   const float *kernel, int kernelSize) {
+    int n = kernelSize / 2;
+    float acc = 0.0f;
+    for (int dx = -n; dx <= n; dx++) {
+        int xi = x + dx;
+        if (xi < 0 || xi >= width) continue;
+        for (int dy = -n; dy <= n; dy++) {
+            const uint8_t *src = window[dy + n];
+            if (!src) continue;
+            acc += src[xi * pixelStep + c] * kernel[(dy + n) * kernelSize + (dx + n)];
+        }
+    }
+    return acc;
+}
+
+
+// One instance of the row convolution per pixel format. PS and CH are the pixel step and the number of
+// filtered channels : constants in the specialized instances, so the channel loop is unrolled and the
+// inner loops carry no bound checks over the interior of the row.
+#define IMAGE_CONVOLVE_ROW(name, PS, CH)                                                              \
+static void name(const uint8_t *const *window, uint8_t *out, const t_image *view,                     \
+                 const float *kernel, int kernelSize, int border, t_image_rounding rounding) {        \
+    int w = view->width, n = kernelSize / 2;                                                          \
+    int pixelStep = (PS), channels = (CH);                                                            \
+    int inside = 1;                                                                                   \
+    for (int k = 0; k < kernelSize; k++) {                                                            \
+        if (!window[k]) inside = 0;                                                                   \
+    }                                                                                                 \
+    /* Columns where the whole kernel lies inside the image */                                        \
+    int first = border > n ? border : n;                                                              \
+    int last = w - first;                                                                             \
+    if (!inside || last < first) first = last = w - border;                                           \
+                                                                                                      \
+    for (int x = border; x < w - border; x++) {                                                       \
+        if (x == first) {                                                                             \
+            for (; x < last; x++) {                                                                   \
+                float acc[4] = {0.0f, 0.0f, 0.0f, 0.0f};                                              \
+                for (int dx = -n; dx <= n; dx++) {                                                    \
+                    for (int dy = -n; dy <= n; dy++) {                                                \
+                        const uint8_t *src = window[dy + n] + (x + dx) * pixelStep;                   \
+                        float k = kernel[(dy + n) * kernelSize + (dx + n)];                           \
+                        for (int c = 0; c < channels; c++) acc[c] += src[c] * k;                      \
+                    }                                                                                 \
+                }                                                                                     \
+                for (int c = 0; c < channels; c++) out[x * pixelStep + c] = toByte(acc[c], rounding); \
+            }                                                                                         \
+            if (x >= w - border) break;                                                               \
+        }                                                                                             \
+        for (int c = 0; c < channels; c++) {                                                          \
+            float acc = convolveSample(window, x, c, w, pixelStep, kernel, kernelSize);               \
+            out[x * pixelStep + c] = toByte(acc, rounding);                                           \
+        }                                                                                             \
+    }                                                                                                 \
+}
+
+IMAGE_CONVOLVE_ROW(convolveRowGray, 1, 1)
+IMAGE_CONVOLVE_ROW(convolveRowRgb, 3, 3)
+IMAGE_CONVOLVE_ROW(convolveRowBgra, 4, 3)
+
+
+/// @brief Convolves one row of an image or of a group of planar rows.
+/// @param window kernelSize rows centered on the row to compute, from the top of the image ; rows outside
+/// the image are NULL and their samples are skipped.
+/// @param out Output row, only the pixels from border to width - border - 1 are written.
+/// @param view Descriptor giving the width and the pixel format of the rows.
+/// @param kernel kernelSize * kernelSize values, row by row from the top.
+/// @param kernelSize Odd size of the square kernel.
+/// @param border Number of pixels left unchanged on the left and right edges.
+/// @param rounding How the results are brought back to bytes.
+void image_convolveRow(const uint8_t *const *window, uint8_t *out, const t_image *view,
+                       const float *kernel, int kernelSize, int border, t_image_rounding rounding) {
+    if (view->pixelStep == 1 && view->channels == 1) {
+        convolveRowGray(window, out, view, kernel, kernelSize, border, rounding);
+    } else if (view->pixelStep == 3 && view->channels == 3) {
+        convolveRowRgb(window, out, view, kernel, kernelSize, border, rounding);
+    } else if (view->pixelStep == 4 && view->channels == 3) {
+        convolveRowBgra(window, out, view, kernel, kernelSize, border, rounding);
+    } else {
+        // Any other format : the sample by sample path
+        for (int x = border; x < view->width - border; x++) {
+            for (int c = 0; c < view->channels; c++) {
+                float acc = convolveSample(window, x, c, view->width, view->pixelStep, kernel, kernelSize);
+                out[x * view->pixelStep + c] = toByte(acc, rounding);
+            }
+        }
+    }
+}
+
+
+/// @brief Convolves an image in place with a square kernel. The source rows read by the kernel are kept
+/// in a ring of kernelSize rows per group, so no copy of the whole image is needed.
+/// @param view Pixels to filter.
+/// @param kernel kernelSize * kernelSize values, row by row from the top.
+/// @param kernelSize Odd size of the square kernel.
+/// @param border Number of pixels left unchanged on each edge ; samples outside the image are skipped.
+/// @param rounding How the results are brought back to bytes.
+/// @return 0 on success, -1 on error.
+int image_convolve(t_image *view, const float *kernel, int kernelSize, int border, t_image_rounding rounding) {
+    if (!view || !view->rows || !kernel || kernelSize < 1 || kernelSize % 2 == 0 || border < 0) return -1;
+
+    int n = kernelSize / 2, span = kernelSize;
+    int w = view->width, h = view->height;
+    if (h <= 2 * border || w <= 2 * border) return 0;
+
+    size_t rowBytes = (size_t)w * view->pixelStep;
+    uint8_t *ring = (uint8_t *)malloc((size_t)span * rowBytes);
+    const uint8_t **window = (const uint8_t **)malloc((size_t)span * sizeof(uint8_t *));
+    if (!ring || !window) {
+        fprintf(stderr, "Memory allocation failed for convolution.\n");
+        free(ring);
+        free(window);
+        return -1;
+    }
+
+    for (int g = 0; g < view->groups; g++) {
+        uint8_t **rows = view->rows + (size_t)g * h;
+
+        // Row y of the source is kept in slot y % span until row y + n has been written
+        for (int y = border - n; y < border + n; y++) {
+            if (y >= 0 && y < h) memcpy(ring + (size_t)(y % span) * rowBytes, rows[y], rowBytes);
+        }
+        for (int y = border; y < h - border; y++) {
+            if (y + n < h) memcpy(ring + (size_t)((y + n) % span) * rowBytes, rows[y + n], rowBytes);
+
+            for (int k = 0; k < span; k++) {
+                int r = y - n + k;
+                window[k] = (r >= 0 && r < h) ? ring + (size_t)(r % span) * rowBytes : NULL;
+            }
+            image_convolveRow(window, rows[y], view, kernel, kernelSize, border, rounding);
+        }
+    }
+
+    free(ring);
+    free(window);
+    return 0;
+}
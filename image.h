@@ -0,0 +1,69 @@
+#ifndef IMAGE_H
+#define IMAGE_H
+
+#include <stdint.h>
+#include "bmp8.h"
+#include "bmp24.h"
+
+// -------------------- HEADER ---------------------------
+//  Name : image.h
+//  Goal : common descriptor over 8-bit and 24-bit images, so point and convolution kernels are written only once
+//  Authors : Amel Boulhamane and Tom Hausmann
+//
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments
+//
+// --------------------------------------------------------
+
+
+// Pixel formats an image descriptor can describe
+typedef enum {
+    IMAGE_GRAY8,      // one sample per pixel (8-bit files)
+    IMAGE_RGB24,      // three interleaved samples per pixel (t_pixel rows, or the BGR rows of a 24-bit file)
+    IMAGE_BGRA32,     // four bytes per pixel, only the first three are filtered
+    IMAGE_PLANAR24    // three groups of rows, one per channel
+} t_image_format;
+
+// A view over the pixels of an image. It does not own the pixels, only the row pointer array.
+// Every group holds height rows, the top row of the image first. A row holds width pixels of pixelStep
+// bytes, of which the first channels are filtered. A t_plane (plane.h) is one channel of such a view.
+typedef struct {
+    t_image_format format;
+    uint8_t **rows;   // groups * height row pointers, group g starts at rows[g * height]
+    int groups;       // 3 for IMAGE_PLANAR24, 1 otherwise
+    int width;        // in pixels
+    int height;
+    int channels;     // samples filtered per pixel
+    int pixelStep;    // bytes between two horizontally adjacent samples of the same channel
+} t_image;
+
+// How a convolution result is brought back to a byte (both clamp to [0, 255] first)
+typedef enum {
+    IMAGE_ROUND,      // to the nearest integer (24-bit filters)
+    IMAGE_TRUNCATE    // towards zero (8-bit filters)
+} t_image_rounding;
+
+// Preset 3x3 kernels shared by the 8-bit and 24-bit filters
+typedef enum {
+    IMAGE_BOX_BLUR,
+    IMAGE_GAUSSIAN_BLUR,
+    IMAGE_OUTLINE,
+    IMAGE_EMBOSS,
+    IMAGE_SHARPEN
+} t_image_kernel;
+
+int image_fromBmp8(t_bmp8 *img, t_image *view);
+int image_fromBmp24(t_bmp24 *img, t_image *view);
+int image_rgbRow(const t_image *view, int y, uint8_t *rgb[3]);
+void image_free(t_image *view);
+const float *image_presetKernel(t_image_kernel kernel);
+
+void image_applyLut(t_image *view, const uint8_t lut[256]);
+void image_negative(t_image *view);
+void image_brightness(t_image *view, int value);
+void image_threshold(t_image *view, int threshold);
+
+void image_convolveRow(const uint8_t *const *window, uint8_t *out, const t_image *view,
+                       const float *kernel, int kernelSize, int border, t_image_rounding rounding);
+int image_convolve(t_image *view, const float *kernel, int kernelSize, int border, t_image_rounding rounding);
+
+#endif // IMAGE_H
@@ -0,0 +1,45 @@
+#ifndef IMAGEF_H
+#define IMAGEF_H
+
+#include "image.h"
+
+// -------------------- HEADER ---------------------------
+//  Name : imagef.h
+//  Goal : working-precision images (float planes) to chain filters with a single quantization at the end
+//  Authors : Amel Boulhamane and Tom Hausmann
+//
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments
+//
+// --------------------------------------------------------
+
+
+// An image held as float planes : samples keep their fractional part and may go below 0 or above 255
+// between two filters, so a chain of filters is rounded and clamped only once.
+typedef struct {
+    float *data;      // planes * height * width samples, plane p starts at data + p * width * height
+    float *scratch;   // second buffer of the same size, used by the convolutions (allocated on first use)
+    int width;
+    int height;
+    int planes;       // 1 (gray) or 3 (red, green, blue)
+} t_image_float;
+
+// How the float samples are brought back to bytes
+typedef enum {
+    IMAGE_QUANTIZE_CLAMP,      // rounded and clamped to [0, 255], like the 8-bit and 24-bit filters
+    IMAGE_QUANTIZE_OFFSET,     // 128 is added first, so signed results (emboss, outline) are centered on mid gray
+    IMAGE_QUANTIZE_ABS,        // absolute value, for edge magnitudes
+    IMAGE_QUANTIZE_NORMALIZE   // the range [min, max] of all the samples is stretched to [0, 255]
+} t_image_quantize;
+
+t_image_float *image_floatFromBmp8(t_bmp8 *img);
+t_image_float *image_floatFromBmp24(t_bmp24 *img);
+int image_floatToBmp8(const t_image_float *fimg, t_bmp8 *img, t_image_quantize mode);
+int image_floatToBmp24(const t_image_float *fimg, t_bmp24 *img, t_image_quantize mode);
+void image_floatFree(t_image_float *fimg);
+
+void image_floatNegative(t_image_float *fimg);
+void image_floatBrightness(t_image_float *fimg, float value);
+int image_floatConvolve(t_image_float *fimg, const float *kernel, int kernelSize, int border);
+int image_floatPreset(t_image_float *fimg, t_image_kernel kernel);
+
+#endif // IMAGEF_H
@@ -0,0 +1,233 @@
+#include "integral.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+// -------------------- HEADER ---------------------------
+//  Name : integral.c
+//  Goal : compute summed-area tables and use them for Bradley and Sauvola adaptive thresholding
+//  Authors : Amel Boulhamane and Tom Hausmann
+// 
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments 
+//
+// --------------------------------------------------------
+
+
+/// @brief Computes the summed-area table of a channel in one pass. Each entry is the running sum of
+/// its row plus the entry just above, so every pixel is read exactly once.
+/// @param plane Channel to integrate.
+/// @param withSquares Non-zero to also build the table of squared samples (needed for variances).
+/// @return Pointer to the new table, or NULL on error.
+t_integral *integral_compute(t_plane *plane, int withSquares) {
+    if (!plane || !plane->rows) return NULL;
+
+    t_integral *table = (t_integral *)malloc(sizeof(t_integral));
+    if (!table) {
+        fprintf(stderr, "Memory allocation failed for integral image.\n");
+        return NULL;
+    }
+
+    int w = plane->width, h = plane->height;
+    size_t tw = (size_t)w + 1;
+    table->width = w;
+    table->height = h;
+    table->sum = (uint64_t *)calloc(tw * (h + 1), sizeof(uint64_t));
+    table->sqsum = withSquares ? (uint64_t *)calloc(tw * (h + 1), sizeof(uint64_t)) : NULL;
+    if (!table->sum || (withSquares && !table->sqsum)) {
+        fprintf(stderr, "Memory allocation failed for integral image.\n");
+        integral_free(table);
+        return NULL;
+    }
+
+    for (int y = 0; y < h; y++) {
+        const uint8_t *src = plane->rows[y];
+        uint64_t *above = table->sum + y * tw;
+        uint64_t *cur = above + tw;
+        uint64_t rowSum = 0;
+
+        for (int x = 0; x < w; x++) {
+            rowSum += src[x * plane->step];
+            cur[x + 1] = above[x + 1] + rowSum;
+        }
+
+        if (withSquares) {
+            uint64_t *sqAbove = table->sqsum + y * tw;
+            uint64_t *sqCur = sqAbove + tw;
+            uint64_t rowSq = 0;
+
+            for (int x = 0; x < w; x++) {
+                uint32_t v = src[x * plane->step];
+                rowSq += v * v;
+                sqCur[x + 1] = sqAbove[x + 1] + rowSq;
+            }
+        }
+    }
+
+    return table;
+}
+
+
+/// @brief Computes the summed-area table of an 8-bit image.
+/// @param img 8-bit image.
+/// @param withSquares Non-zero to also build the table of squared samples.
+/// @return Pointer to the new table, or NULL on error.
+t_integral *bmp8_computeIntegral(t_bmp8 *img, int withSquares) {
+    t_plane plane;
+    if (plane_fromBmp8(img, &plane) != 0) return NULL;
+
+    t_integral *table = integral_compute(&plane, withSquares);
+    plane_free(&plane);
+    return table;
+}
+
+
+/// @brief Computes one summed-area table per channel of a 24-bit image.
+/// @param img 24-bit image.
+/// @param withSquares Non-zero to also build the tables of squared samples.
+/// @param channels Receives the red, green and blue tables (in this order).
+/// @return 0 on success, -1 on error (no table is left allocated).
+int bmp24_computeIntegral(t_bmp24 *img, int withSquares, t_integral *channels[3]) {
+    if (!img || !channels) return -1;
+
+    for (int c = 0; c < 3; c++) {
+        t_plane plane;
+        channels[c] = NULL;
+        if (plane_fromBmp24(img, c, &plane) == 0) {
+            channels[c] = integral_compute(&plane, withSquares);
+            plane_free(&plane);
+        }
+        if (!channels[c]) {
+            for (int j = 0; j < c; j++) {
+                integral_free(channels[j]);
+                channels[j] = NULL;
+            }
+            return -1;
+        }
+    }
+    return 0;
+}
+
+
+/// @brief Frees a summed-area table.
+/// @param table Table to free.
+void integral_free(t_integral *table) {
+    if (!table) return;
+    free(table->sum);
+    free(table->sqsum);
+    free(table);
+}
+
+
+/// @brief Reads a rectangle sum from a table with four lookups.
+static uint64_t rectSum(const uint64_t *t, int w, int x0, int y0, int x1, int y1) {
+    size_t tw = (size_t)w + 1;
+    return t[y1 * tw + x1] - t[y0 * tw + x1] - t[y1 * tw + x0] + t[y0 * tw + x0];
+}
+
+
+/// @brief Sum of the samples in [x0, x1[ x [y0, y1[. Coordinates must lie inside the image.
+/// @param table Summed-area table.
+/// @param x0 @param y0 Top-left corner (included).
+/// @param x1 @param y1 Bottom-right corner (excluded).
+/// @return The sum of the samples of the rectangle.
+uint64_t integral_sum(const t_integral *table, int x0, int y0, int x1, int y1) {
+    return rectSum(table->sum, table->width, x0, y0, x1, y1);
+}
+
+
+/// @brief Sum of the squared samples in [x0, x1[ x [y0, y1[.
+/// @param table Summed-area table built with withSquares.
+/// @return The sum of squares, or 0 if the table has no squared sums.
+uint64_t integral_sqsum(const t_integral *table, int x0, int y0, int x1, int y1) {
+    if (!table->sqsum) return 0;
+    return rectSum(table->sqsum, table->width, x0, y0, x1, y1);
+}
+
+
+/// @brief Mean of the samples in [x0, x1[ x [y0, y1[.
+/// @return The mean value, or 0 for an empty rectangle.
+double integral_mean(const t_integral *table, int x0, int y0, int x1, int y1) {
+    uint64_t area = (uint64_t)(x1 - x0) * (uint64_t)(y1 - y0);
+    if (area == 0) return 0.0;
+    return (double)integral_sum(table, x0, y0, x1, y1) / (double)area;
+}
+
+
+/// @brief Bradley local threshold: a pixel becomes black when it is more than percent % darker than
+/// the mean of the windowSize x windowSize window around it (the window is clipped at the borders).
+/// @param img 8-bit image to binarize.
+/// @param windowSize Side of the window in pixels.
+/// @param percent How much darker than the local mean a pixel must be to turn black (usually 15), clamped to [0, 100].
+void bmp8_bradleyThreshold(t_bmp8 *img, int windowSize, int percent) {
+    if (!img || !img->data || windowSize < 1) return;
+    if (percent < 0) percent = 0;
+    if (percent > 100) percent = 100;
+
+    t_plane plane;
+    if (plane_fromBmp8(img, &plane) != 0) return;
+    t_integral *table = integral_compute(&plane, 0);
+    if (!table) {
+        plane_free(&plane);
+        return;
+    }
+
+    int w = plane.width, h = plane.height, half = windowSize / 2;
+    for (int y = 0; y < h; y++) {
+        int y0 = y - half < 0 ? 0 : y - half;
+        int y1 = y + half + 1 > h ? h : y + half + 1;
+        uint8_t *row = plane.rows[y];
+
+        for (int x = 0; x < w; x++) {
+            int x0 = x - half < 0 ? 0 : x - half;
+            int x1 = x + half + 1 > w ? w : x + half + 1;
+            uint64_t area = (uint64_t)(x1 - x0) * (y1 - y0);
+            uint64_t sum = integral_sum(table, x0, y0, x1, y1);
+
+            // value < mean * (100 - percent) / 100, without any division
+            row[x] = (row[x] * area * 100 < sum * (uint64_t)(100 - percent)) ? 0 : 255;
+        }
+    }
+
+    integral_free(table);
+    plane_free(&plane);
+}
+
+
+/// @brief Sauvola local threshold: T = m * (1 + k * (s / 128 - 1)) where m and s are the mean and
+/// standard deviation of the window around the pixel. Works well on documents with uneven lighting.
+/// @param img 8-bit image to binarize.
+/// @param windowSize Side of the window in pixels.
+/// @param k Sensitivity to the local contrast (usually between 0.2 and 0.5).
+void bmp8_sauvolaThreshold(t_bmp8 *img, int windowSize, float k) {
+    if (!img || !img->data || windowSize < 1) return;
+
+    t_plane plane;
+    if (plane_fromBmp8(img, &plane) != 0) return;
+    t_integral *table = integral_compute(&plane, 1);
+    if (!table) {
+        plane_free(&plane);
+        return;
+    }
+
+    int w = plane.width, h = plane.height, half = windowSize / 2;
+    for (int y = 0; y < h; y++) {
+        int y0 = y - half < 0 ? 0 : y - half;
+        int y1 = y + half + 1 > h ? h : y + half + 1;
+        uint8_t *row = plane.rows[y];
+
+        for (int x = 0; x < w; x++) {
+            int x0 = x - half < 0 ? 0 : x - half;
+            int x1 = x + half + 1 > w ? w : x + half + 1;
+            double area = (double)(x1 - x0) * (y1 - y0);
+            double mean = integral_sum(table, x0, y0, x1, y1) / area;
+            double var = integral_sqsum(table, x0, y0, x1, y1) / area - mean * mean;
+            double dev = var > 0 ? sqrt(var) : 0.0;
+            double t = mean * (1.0 + k * (dev / 128.0 - 1.0));
+
+            row[x] = (row[x] > t) ? 255 : 0;
+        }
+    }
+
+    integral_free(table);
+    plane_free(&plane);
+}
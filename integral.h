@@ -0,0 +1,43 @@
+#ifndef INTEGRAL_H
+#define INTEGRAL_H
+
+#include <stdint.h>
+#include "bmp8.h"
+#include "bmp24.h"
+#include "plane.h"
+
+// -------------------- HEADER ---------------------------
+//  Name : integral.h
+//  Goal : summed-area tables (integral images) and the local adaptive thresholds built on them
+//  Authors : Amel Boulhamane and Tom Hausmann
+// 
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments 
+//
+// --------------------------------------------------------
+
+
+// Summed-area table of one channel. Entry (x, y) holds the sum of all samples above and to the left
+// of pixel (x, y), so the table has (width + 1) x (height + 1) entries and its first row/column are 0.
+typedef struct {
+    int width;
+    int height;
+    uint64_t *sum;     // Sum of the samples
+    uint64_t *sqsum;   // Sum of the squared samples, NULL if not requested
+} t_integral;
+
+// Builds the table(s) in a single pass over the pixels
+t_integral *integral_compute(t_plane *plane, int withSquares);
+t_integral *bmp8_computeIntegral(t_bmp8 *img, int withSquares);
+int bmp24_computeIntegral(t_bmp24 *img, int withSquares, t_integral *channels[3]);
+void integral_free(t_integral *table);
+
+// O(1) queries over the rectangle [x0, x1[ x [y0, y1[ (top row = 0)
+uint64_t integral_sum(const t_integral *table, int x0, int y0, int x1, int y1);
+uint64_t integral_sqsum(const t_integral *table, int x0, int y0, int x1, int y1);
+double integral_mean(const t_integral *table, int x0, int y0, int x1, int y1);
+
+// Local adaptive thresholds, constant time per pixel whatever the window size
+void bmp8_bradleyThreshold(t_bmp8 *img, int windowSize, int percent);
+void bmp8_sauvolaThreshold(t_bmp8 *img, int windowSize, float k);
+
+#endif // INTEGRAL_H
@@ -0,0 +1,149 @@
+#include "levels.h"
+#include "image.h"
+#include <stdio.h>
+#include <string.h>
+
+// -------------------- HEADER ---------------------------
+//  Name : levels.c
+//  Goal : auto levels : linear contrast stretching between two histogram percentiles
+//  Authors : Amel Boulhamane and Tom Hausmann
+//
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments
+//
+// --------------------------------------------------------
+
+
+/// @brief Builds the lookup table stretching the levels between two percentiles of a histogram to [0, 255].
+/// The darkest and brightest clipPercent % of the samples become 0 and 255.
+/// @param hist Histogram (256 bins).
+/// @param total Number of samples counted in the histogram.
+/// @param clipPercent Percentage clipped at each end (e.g. 0.5), 0 to stretch between the extreme levels.
+/// @param lut Receives the 256 new values (the identity if the histogram has a single level).
+void levels_computeLut(const unsigned int hist[256], unsigned int total, float clipPercent, uint8_t lut[256]) {
+    if (clipPercent < 0.0f) clipPercent = 0.0f;
+    if (clipPercent > 50.0f) clipPercent = 50.0f;
+    unsigned int clip = (unsigned int)((double)total * clipPercent / 100.0);
+
+    // low : first level with more than clip samples at or below it ; high : the same from the top
+    int low = 0, high = 255;
+    unsigned int count = 0;
+    for (low = 0; low < 255; low++) {
+        count += hist[low];
+        if (count > clip) break;
+    }
+    count = 0;
+    for (high = 255; high > 0; high--) {
+        count += hist[high];
+        if (count > clip) break;
+    }
+
+    for (int v = 0; v < 256; v++) {
+        if (high <= low) {
+            lut[v] = (uint8_t)v;
+        } else if (v <= low) {
+            lut[v] = 0;
+        } else if (v >= high) {
+            lut[v] = 255;
+        } else {
+            lut[v] = (uint8_t)(((v - low) * 255 + (high - low) / 2) / (high - low));
+        }
+    }
+}
+
+
+/// @brief Stretches the contrast of an 8-bit image between two percentiles of its histogram.
+/// @param img Image to modify.
+/// @param clipPercent Percentage of the pixels clipped to black and to white (e.g. 0.5).
+/// @return 0 on success, -1 on error.
+int bmp8_autoLevels(t_bmp8 *img, float clipPercent) {
+    t_image view;
+    if (image_fromBmp8(img, &view) != 0) return -1;
+
+    // One pass for the histogram, each thread counting its rows in a private histogram
+    unsigned int hist[256] = {0};
+    #pragma omp parallel
+    {
+        unsigned int local[256] = {0};
+        #pragma omp for nowait
+        for (int y = 0; y < view.height; y++) {
+            const uint8_t *row = view.rows[y];
+            for (int x = 0; x < view.width; x++) local[row[x]]++;
+        }
+        #pragma omp critical
+        for (int v = 0; v < 256; v++) hist[v] += local[v];
+    }
+
+    // One pass for the stretch
+    uint8_t lut[256];
+    levels_computeLut(hist, img->width * img->height, clipPercent, lut);
+    image_applyLut(&view, lut);
+    image_free(&view);
+    return 0;
+}
+
+
+/// @brief Stretches the contrast of a 24-bit image (any layout) between two percentiles of its histogram.
+/// Unlike bmp24_equalize, no pixel goes through YUV : the luminance is a fixed-point weighted sum and
+/// the stretch a lookup table.
+/// @param img Image to modify.
+/// @param clipPercent Percentage of the samples clipped at each end (e.g. 0.5).
+/// @param mode LEVELS_LUMINANCE or LEVELS_PER_CHANNEL.
+/// @return 0 on success, -1 on error.
+int bmp24_autoLevels(t_bmp24 *img, float clipPercent, t_levels_mode mode) {
+    t_image view;
+    if (image_fromBmp24(img, &view) != 0) return -1;
+
+    int perChannel = (mode == LEVELS_PER_CHANNEL);
+    unsigned int hist[3][256];
+    memset(hist, 0, sizeof(hist));
+
+    #pragma omp parallel
+    {
+        unsigned int local[3][256];
+        memset(local, 0, sizeof(local));
+        #pragma omp for nowait
+        for (int y = 0; y < view.height; y++) {
+            uint8_t *rgb[3];
+            int step = image_rgbRow(&view, y, rgb);
+            const uint8_t *r = rgb[0], *g = rgb[1], *b = rgb[2];
+            if (perChannel) {
+                for (int x = 0; x < view.width; x++) {
+                    local[0][r[x * step]]++;
+                    local[1][g[x * step]]++;
+                    local[2][b[x * step]]++;
+                }
+            } else {
+                // BT.601 luminance in 8.8 fixed point, like the gray conversion
+                for (int x = 0; x < view.width; x++) {
+                    local[0][(77 * r[x * step] + 150 * g[x * step] + 29 * b[x * step] + 128) >> 8]++;
+                }
+            }
+        }
+        #pragma omp critical
+        for (int c = 0; c < 3; c++) {
+            for (int v = 0; v < 256; v++) hist[c][v] += local[c][v];
+        }
+    }
+
+    unsigned int total = (unsigned int)img->width * img->height;
+    uint8_t lut[3][256];
+    for (int c = 0; c < (perChannel ? 3 : 1); c++) {
+        levels_computeLut(hist[c], total, clipPercent, lut[c]);
+    }
+    if (!perChannel) {
+        memcpy(lut[1], lut[0], 256);
+        memcpy(lut[2], lut[0], 256);
+    }
+
+    #pragma omp parallel for
+    for (int y = 0; y < view.height; y++) {
+        uint8_t *rgb[3];
+        int step = image_rgbRow(&view, y, rgb);
+        for (int c = 0; c < 3; c++) {
+            uint8_t *s = rgb[c];
+            for (int x = 0; x < view.width; x++) s[x * step] = lut[c][s[x * step]];
+        }
+    }
+    image_free(&view);
+    return 0;
+}
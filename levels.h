@@ -0,0 +1,27 @@
+#ifndef LEVELS_H
+#define LEVELS_H
+
+#include "bmp8.h"
+#include "bmp24.h"
+
+// -------------------- HEADER ---------------------------
+//  Name : levels.h
+//  Goal : auto levels : linear contrast stretching between two histogram percentiles
+//  Authors : Amel Boulhamane and Tom Hausmann
+//
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments
+//
+// --------------------------------------------------------
+
+
+// Histogram the percentiles of a color image are taken from
+typedef enum {
+    LEVELS_LUMINANCE,    // one stretch for the three channels, from the BT.601 luminance (keeps the hues)
+    LEVELS_PER_CHANNEL   // one stretch per channel (also removes color casts)
+} t_levels_mode;
+
+void levels_computeLut(const unsigned int hist[256], unsigned int total, float clipPercent, uint8_t lut[256]);
+int bmp8_autoLevels(t_bmp8 *img, float clipPercent);
+int bmp24_autoLevels(t_bmp24 *img, float clipPercent, t_levels_mode mode);
+
+#endif // LEVELS_H
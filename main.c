@@ -3,8 +3,22 @@
 #include <stdint.h>
 #include "bmp8.h"
 #include "bmp24.h"
+#include "probe.h"
 #include "equalize8.h"
 #include "equalize24.h"
+#include "integral.h"
+#include "median.h"
+#include "rank.h"
+#include "morphology.h"
+#include "gradient.h"
+#include "canny.h"
+#include "gray.h"
+#include "colormatrix.h"
+#include "levels.h"
+#include "histmatch.h"
+#include "resize.h"
+#include "orient.h"
+#include "warp.h"
 
 // -------------------- HEADER ---------------------------
 //  Name : main.c
@@ -15,19 +29,131 @@
 //
 // --------------------------------------------------------
 
-// This is used as detection for the bit depth of the images
-/// @brief Detects bit depth of BMP image file by reading header information.
-/// @param filename Path to the BMP file to analyze.
-/// @return Bit depth (8 or 24) if supported, -1 if unsupported or error.
-int detectBitDepth(const char *filename) {
-    FILE *f = fopen(filename, "rb");
-    if (!f) return -1;
-    fseek(f, 28, SEEK_SET);
-    uint16_t bits;
-    fread(&bits, sizeof(uint16_t), 1, f);
-    printf("bits = %d\n", bits);
-    fclose(f);
-    return (bits == 8 || bits == 24) ? bits : -1;
+// This is used by the filters that produce a new 8-bit image instead of modifying the current one
+/// @brief Asks for an output file name, saves the new 8-bit image there and frees it.
+/// @param out New image (may be NULL if the filter failed).
+static void saveNewImage8(t_bmp8 *out) {
+    char filename[256];
+    if (!out) {
+        printf("Filter failed.\n");
+        return;
+    }
+    printf("Enter output file name for the 8-bit result: ");
+    scanf("%255s", filename);
+    getchar();
+    if (bmp8_saveImage(filename, out) == 0) {
+        printf("Result saved in %s\n", filename);
+    }
+    bmp8_free(out);
+}
+
+
+/// @brief Asks for an output file name, saves the new 24-bit image there and frees it.
+/// @param out New image (may be NULL if the filter failed).
+static void saveNewImage24(t_bmp24 *out) {
+    char filename[256];
+    if (!out) {
+        printf("Filter failed.\n");
+        return;
+    }
+    printf("Enter output file name for the result: ");
+    scanf("%255s", filename);
+    getchar();
+    if (bmp24_saveImage(filename, out) == 0) {
+        printf("Result saved in %s\n", filename);
+    }
+    bmp24_free(out);
+}
+
+
+/// @brief Asks for the size and the filter of a resize.
+/// @param width @param height Receive the new size.
+/// @param filter Receives the filter.
+/// @return 0 on success, -1 if the parameters are invalid.
+static int readResize(int *width, int *height, t_resize_filter *filter) {
+    int choice;
+    printf("New width and height (e.g. 320 240): ");
+    scanf("%d %d", width, height);
+    printf("Filter (0 = nearest, 1 = bilinear, 2 = bicubic, 3 = area): ");
+    scanf("%d", &choice);
+    getchar();
+    if (*width < 1 || *height < 1 || choice < 0 || choice > 3) {
+        printf("Invalid parameters.\n");
+        return -1;
+    }
+    *filter = (t_resize_filter)choice;
+    return 0;
+}
+
+
+/// @brief Asks for a rotation or flip.
+/// @param op Receives the operation.
+/// @return 0 on success, -1 if the choice is invalid.
+static int readOrient(t_orient *op) {
+    int choice;
+    printf("1. Rotate 90 (clockwise)\n2. Rotate 180\n3. Rotate 270 (counter-clockwise)\n");
+    printf("4. Flip horizontally\n5. Flip vertically\n6. Transpose\n7. Transverse\n");
+    printf("Operation: ");
+    scanf("%d", &choice);
+    getchar();
+    if (choice < 1 || choice > 7) {
+        printf("Invalid parameters.\n");
+        return -1;
+    }
+    *op = (t_orient)(choice - 1);
+    return 0;
+}
+
+
+/// @brief Asks for a rotation angle and a background, and builds the rotation around the center of an image.
+/// @param width @param height Size of the image.
+/// @param rotation Receives the transform.
+/// @param white Receives 1 for a white background, 0 for black.
+/// @return 0 on success, -1 if the parameters are invalid.
+static int readDeskew(int width, int height, t_affine *rotation, int *white) {
+    double degrees;
+    printf("Angle in degrees (clockwise, e.g. -1.5): ");
+    scanf("%lf", &degrees);
+    printf("Background (0 = black, 1 = white): ");
+    scanf("%d", white);
+    getchar();
+    if (*white != 0 && *white != 1) {
+        printf("Invalid parameters.\n");
+        return -1;
+    }
+    affine_rotate(rotation, degrees, width / 2.0, height / 2.0);
+    return 0;
+}
+
+
+/// @brief Asks for a reference image (8-bit or 24-bit) and builds its histogram matching reference.
+/// @param target Receives the reference.
+/// @return 0 on success, -1 on error.
+static int readMatchTarget(t_hist_target *target) {
+    char filename[256];
+    t_bmp_probe probe;
+    printf("Reference image: ");
+    scanf("%255s", filename);
+    getchar();
+    if (bmp_probe(filename, &probe) != 0) return -1;
+
+    int result = -1;
+    if (probe.bits == 8) {
+        t_bmp8 *ref = bmp8_loadFromProbe(&probe);
+        if (ref) {
+            result = histmatch_fromBmp8(ref, target);
+            bmp8_free(ref);
+        }
+    } else if (probe.bits == 24 || probe.bits == 32) {
+        t_bmp24 *ref = bmp24_loadFromProbe(&probe);
+        if (ref) {
+            result = histmatch_fromBmp24(ref, target);
+            bmp24_free(ref);
+        }
+    } else {
+        bmp_probeClose(&probe);
+    }
+    return result;
 }
 
 
@@ -48,7 +174,19 @@ void applyFilters8(t_bmp8 *img) {
         printf("7. Emboss\n");
         printf("8. Sharpen\n");
         printf("9. Histogram Equalization\n");
-        printf("10. Return to main menu\n \n");
+        printf("10. Adaptive threshold (Bradley)\n");
+        printf("11. Adaptive threshold (Sauvola)\n");
+        printf("12. Median filter (denoise)\n");
+        printf("13. Fast 3x3 / 5x5 median, min or max\n");
+        printf("14. Morphology (erode, dilate, open, close, top-hat)\n");
+        printf("15. Gradient magnitude (Sobel / Scharr, saved as a new image)\n");
+        printf("16. Canny edge detection (saved as a new image)\n");
+        printf("17. Auto levels (contrast stretch)\n");
+        printf("18. Histogram matching to a reference image\n");
+        printf("19. Resize (saved as a new image)\n");
+        printf("20. Rotate or flip\n");
+        printf("21. Rotate by any angle / deskew (saved as a new image)\n");
+        printf("22. Return to main menu\n \n");
         printf(">>> Your choice: ");
         scanf("%d", &choice);
         getchar();
@@ -76,61 +214,154 @@ void applyFilters8(t_bmp8 *img) {
                 printf("Black and white applied.\n");
                 break;
             }
-            case 4: {
-                float kernel[3][3] = {
-                    {1.0f/9, 1.0f/9, 1.0f/9},
-                    {1.0f/9, 1.0f/9, 1.0f/9},
-                    {1.0f/9, 1.0f/9, 1.0f/9}
-                };
-                bmp8_applyFilter(img, (float **)kernel, 3);
+            case 4:
+                bmp8_boxBlur(img);
                 printf("Box Blur applied.\n");
                 break;
-            }
-            case 5: {
-                float kernel[3][3] = {
-                    {1.0f/16, 2.0f/16, 1.0f/16},
-                    {2.0f/16, 4.0f/16, 2.0f/16},
-                    {1.0f/16, 2.0f/16, 1.0f/16}
-                };
-                bmp8_applyFilter(img, (float **)kernel, 3);
+            case 5:
+                bmp8_gaussianBlur(img);
                 printf("Gaussian Blur applied.\n");
                 break;
-            }
-            case 6: {
-                float kernel[3][3] = {
-                    {-1, -1, -1},
-                    {-1,  8, -1},
-                    {-1, -1, -1}
-                };
-                bmp8_applyFilter(img, (float **)kernel, 3);
+            case 6:
+                bmp8_outline(img);
                 printf("Outline filter applied.\n");
                 break;
-            }
-            case 7: {
-                float kernel[3][3] = {
-                    {-2, -1, 0},
-                    {-1,  1, 1},
-                    { 0,  1, 2}
-                };
-                bmp8_applyFilter(img, (float **)kernel, 3);
+            case 7:
+                bmp8_emboss(img);
                 printf("Emboss filter applied.\n");
                 break;
-            }
-            case 8: {
-                float kernel[3][3] = {
-                    { 0, -1,  0},
-                    {-1,  5, -1},
-                    { 0, -1,  0}
-                };
-                bmp8_applyFilter(img, (float **)kernel, 3);
+            case 8:
+                bmp8_sharpen(img);
                 printf("Sharpen filter applied.\n");
                 break;
-            }
             case 9:
                 bmp8_equalize(img);
                 printf("Histogram Equalization applied.\n");
                 break;
-            case 10:
+            case 10: {
+                int windowSize, percent;
+                printf("Window size (e.g. 31): ");
+                scanf("%d", &windowSize);
+                printf("Percentage below the local mean (e.g. 15): ");
+                scanf("%d", &percent);
+                getchar();
+                bmp8_bradleyThreshold(img, windowSize, percent);
+                printf("Bradley threshold applied.\n");
+                break;
+            }
+            case 11: {
+                int windowSize;
+                float k;
+                printf("Window size (e.g. 31): ");
+                scanf("%d", &windowSize);
+                printf("Sensitivity k (e.g. 0.34): ");
+                scanf("%f", &k);
+                getchar();
+                bmp8_sauvolaThreshold(img, windowSize, k);
+                printf("Sauvola threshold applied.\n");
+                break;
+            }
+            case 12: {
+                int radius;
+                printf("Radius (1 for 3x3, 2 for 5x5...): ");
+                scanf("%d", &radius);
+                getchar();
+                bmp8_median(img, radius);
+                printf("Median filter applied.\n");
+                break;
+            }
+            case 13: {
+                int size, op;
+                printf("Window size (3 or 5): ");
+                scanf("%d", &size);
+                printf("Filter (0 = median, 1 = min, 2 = max): ");
+                scanf("%d", &op);
+                getchar();
+                if ((size != 3 && size != 5) || op < 0 || op > 2) {
+                    printf("Invalid parameters.\n");
+                    break;
+                }
+                bmp8_rankFilter(img, size, (t_rank_op)op);
+                printf("Rank filter applied.\n");
+                break;
+            }
+            case 14: {
+                int op, seWidth, seHeight;
+                printf("Operation (0 = erode, 1 = dilate, 2 = open, 3 = close, 4 = top-hat, 5 = black-hat): ");
+                scanf("%d", &op);
+                printf("Structuring element width and height (e.g. 5 5): ");
+                scanf("%d %d", &seWidth, &seHeight);
+                getchar();
+                if (op < 0 || op > 5 || seWidth < 1 || seHeight < 1) {
+                    printf("Invalid parameters.\n");
+                    break;
+                }
+                bmp8_morphology(img, seWidth, seHeight, (t_morph_op)op);
+                printf("Morphology applied.\n");
+                break;
+            }
+            case 15: {
+                int kernel, norm;
+                printf("Kernel (0 = Sobel, 1 = Scharr): ");
+                scanf("%d", &kernel);
+                printf("Magnitude (1 = L1, 2 = L2): ");
+                scanf("%d", &norm);
+                getchar();
+                saveNewImage8(bmp8_gradient(img, kernel == 1 ? GRADIENT_SCHARR : GRADIENT_SOBEL,
+                                             norm == 2 ? GRADIENT_L2 : GRADIENT_L1, NULL));
+                break;
+            }
+            case 16: {
+                int low, high;
+                printf("Low and high thresholds (e.g. 20 50): ");
+                scanf("%d %d", &low, &high);
+                getchar();
+                saveNewImage8(bmp8_canny(img, low, high));
+                break;
+            }
+            case 17: {
+                float clip;
+                printf("Percentage clipped at each end (e.g. 0.5): ");
+                scanf("%f", &clip);
+                getchar();
+                bmp8_autoLevels(img, clip);
+                printf("Auto levels applied.\n");
+                break;
+            }
+            case 18: {
+                t_hist_target target;
+                if (readMatchTarget(&target) == 0 && bmp8_matchHistogram(img, &target) == 0) {
+                    printf("Histogram matched.\n");
+                } else {
+                    printf("Histogram matching failed.\n");
+                }
+                break;
+            }
+            case 19: {
+                int width, height;
+                t_resize_filter filter;
+                if (readResize(&width, &height, &filter) == 0) {
+                    saveNewImage8(bmp8_resize(img, width, height, filter));
+                }
+                break;
+            }
+            case 20: {
+                t_orient op;
+                if (readOrient(&op) == 0) {
+                    if (bmp8_orient(img, op) == 0) printf("Orientation applied.\n");
+                    else printf("Orientation failed.\n");
+                }
+                break;
+            }
+            case 21: {
+                t_affine rotation;
+                int white;
+                if (readDeskew(img->width, img->height, &rotation, &white) == 0) {
+                    saveNewImage8(bmp8_warp(img, &rotation, img->width, img->height, white ? 255 : 0));
+                }
+                break;
+            }
+            case 22:
                 return;
             default:
                 printf("Invalid option.\n");
@@ -157,7 +388,19 @@ void applyFilters24(t_bmp24 *img) {
         printf("7. Emboss\n");
         printf("8. Sharpen\n");
         printf("9. Histogram Equalization\n");
-        printf("10. Return to main menu\n");
+        printf("10. Median filter (denoise)\n");
+        printf("11. Fast 3x3 / 5x5 median, min or max\n");
+        printf("12. Morphology (erode, dilate, open, close, top-hat)\n");
+        printf("13. Gradient magnitude (Sobel / Scharr, saved as a new 8-bit image)\n");
+        printf("14. Canny edge detection (saved as a new 8-bit image)\n");
+        printf("15. Grayscale (saved as a new 8-bit image)\n");
+        printf("16. Color adjustments (white balance, saturation, sepia) in one pass\n");
+        printf("17. Auto levels (contrast stretch)\n");
+        printf("18. Histogram matching to a reference image\n");
+        printf("19. Resize (saved as a new image)\n");
+        printf("20. Rotate or flip\n");
+        printf("21. Rotate by any angle / deskew (saved as a new image)\n");
+        printf("22. Return to main menu\n");
         printf(">>> Your choice: ");
         scanf("%d", &choice);
         getchar();
@@ -204,7 +447,150 @@ void applyFilters24(t_bmp24 *img) {
                 bmp24_equalize(img);
             printf("Histogram Equalization applied.\n");
             break;
-            case 10:
+            case 10: {
+                int radius;
+                printf("Radius (1 for 3x3, 2 for 5x5...): ");
+                scanf("%d", &radius);
+                getchar();
+                bmp24_median(img, radius);
+                printf("Median filter applied.\n");
+                break;
+            }
+            case 11: {
+                int size, op;
+                printf("Window size (3 or 5): ");
+                scanf("%d", &size);
+                printf("Filter (0 = median, 1 = min, 2 = max): ");
+                scanf("%d", &op);
+                getchar();
+                if ((size != 3 && size != 5) || op < 0 || op > 2) {
+                    printf("Invalid parameters.\n");
+                    break;
+                }
+                bmp24_rankFilter(img, size, (t_rank_op)op);
+                printf("Rank filter applied.\n");
+                break;
+            }
+            case 12: {
+                int op, seWidth, seHeight;
+                printf("Operation (0 = erode, 1 = dilate, 2 = open, 3 = close, 4 = top-hat, 5 = black-hat): ");
+                scanf("%d", &op);
+                printf("Structuring element width and height (e.g. 5 5): ");
+                scanf("%d %d", &seWidth, &seHeight);
+                getchar();
+                if (op < 0 || op > 5 || seWidth < 1 || seHeight < 1) {
+                    printf("Invalid parameters.\n");
+                    break;
+                }
+                bmp24_morphology(img, seWidth, seHeight, (t_morph_op)op);
+                printf("Morphology applied.\n");
+                break;
+            }
+            case 13: {
+                int kernel, norm;
+                printf("Kernel (0 = Sobel, 1 = Scharr): ");
+                scanf("%d", &kernel);
+                printf("Magnitude (1 = L1, 2 = L2): ");
+                scanf("%d", &norm);
+                getchar();
+                saveNewImage8(bmp24_gradient(img, kernel == 1 ? GRADIENT_SCHARR : GRADIENT_SOBEL,
+                                              norm == 2 ? GRADIENT_L2 : GRADIENT_L1, NULL));
+                break;
+            }
+            case 14: {
+                int low, high;
+                printf("Low and high thresholds (e.g. 20 50): ");
+                scanf("%d %d", &low, &high);
+                getchar();
+                saveNewImage8(bmp24_canny(img, low, high));
+                break;
+            }
+            case 15: {
+                int weights;
+                printf("Weights (0 = average, 1 = BT.601, 2 = BT.709): ");
+                scanf("%d", &weights);
+                getchar();
+                if (weights < 0 || weights > 2) {
+                    printf("Invalid parameters.\n");
+                    break;
+                }
+                saveNewImage8(bmp24_toGray8(img, (t_gray_weights)weights));
+                break;
+            }
+            case 16: {
+                float red, green, blue, saturation;
+                int sepia;
+                printf("Red, green and blue gains (e.g. 1.1 1 0.9): ");
+                scanf("%f %f %f", &red, &green, &blue);
+                printf("Saturation (0 = gray, 1 = unchanged, e.g. 1.3): ");
+                scanf("%f", &saturation);
+                printf("Sepia (0 = no, 1 = yes): ");
+                scanf("%d", &sepia);
+                getchar();
+
+                // The adjustments are composed into a single matrix, so the pixels are rounded only once
+                t_color_matrix total, step;
+                color_gains(&total, red, green, blue);
+                color_saturation(&step, saturation);
+                color_compose(&total, &step, &total);
+                if (sepia == 1) {
+                    color_sepia(&step);
+                    color_compose(&total, &step, &total);
+                }
+                if (bmp24_colorMatrix(img, &total) == 0) {
+                    printf("Color adjustments applied.\n");
+                } else {
+                    printf("Invalid parameters.\n");
+                }
+                break;
+            }
+            case 17: {
+                float clip;
+                int mode;
+                printf("Percentage clipped at each end (e.g. 0.5): ");
+                scanf("%f", &clip);
+                printf("Levels from (0 = luminance, 1 = each channel): ");
+                scanf("%d", &mode);
+                getchar();
+                bmp24_autoLevels(img, clip, mode == 1 ? LEVELS_PER_CHANNEL : LEVELS_LUMINANCE);
+                printf("Auto levels applied.\n");
+                break;
+            }
+            case 18: {
+                t_hist_target target;
+                if (readMatchTarget(&target) == 0 && bmp24_matchHistogram(img, &target) == 0) {
+                    printf("Histogram matched.\n");
+                } else {
+                    printf("Histogram matching failed.\n");
+                }
+                break;
+            }
+            case 19: {
+                int width, height;
+                t_resize_filter filter;
+                if (readResize(&width, &height, &filter) == 0) {
+                    saveNewImage24(bmp24_resize(img, width, height, filter));
+                }
+                break;
+            }
+            case 20: {
+                t_orient op;
+                if (readOrient(&op) == 0) {
+                    if (bmp24_orient(img, op) == 0) printf("Orientation applied.\n");
+                    else printf("Orientation failed.\n");
+                }
+                break;
+            }
+            case 21: {
+                t_affine rotation;
+                int white;
+                if (readDeskew(img->width, img->height, &rotation, &white) == 0) {
+                    t_pixel background = {white ? 255 : 0, white ? 255 : 0, white ? 255 : 0};
+                    saveNewImage24(bmp24_warp(img, &rotation, img->width, img->height, background));
+                }
+                break;
+            }
+            case 22:
                 return;
             default:
                 printf("Invalid option.\n");
@@ -252,13 +638,14 @@ int main(void) {
         printf("2. Save image\n");
         printf("3. Apply a filter\n");
         printf("4. Display image information\n");
-        printf("5. Quit\n \n");
+        printf("5. Make a thumbnail of a file\n");
+        printf("6. Quit\n \n");
         printf(">>> Your choice: ");
 
         char input[10];
         fgets(input, sizeof(input), stdin);
         if (sscanf(input, "%d", &choice) != 1) {
-            printf("Invalid option. Please choose 1 to 5.\n");
+            printf("Invalid option. Please choose 1 to 6.\n");
             continue;
         }
 
@@ -268,7 +655,9 @@ int main(void) {
                 scanf("%255s", filepath);
                 getchar();
 
-                bits = detectBitDepth(filepath);
+                // The headers are read once : the loaders reuse the open file of the probe
+                t_bmp_probe probe;
+                bits = bmp_probe(filepath, &probe) == 0 ? probe.bits : -1;
 
                 if (img8) {
                     bmp8_free(img8);
@@ -280,32 +669,40 @@ int main(void) {
                 }
 
                 if (bits == 8) {
-                    img8 = bmp8_loadImage(filepath);
+                    img8 = bmp8_loadFromProbe(&probe);
                     if (!img8) {
                         printf("Failed to load 8-bit image.\n");
                         bits = -1;
                     } else {
                         printf("8-bit image loaded successfully.\n");
                     }
-                } else if (bits == 24) {
-                    img24 = bmp24_loadImage(filepath);
+                } else if (bits == 24 || bits == 32) {
+                    // 32-bit images are handled by the 24-bit code, their alpha channel is kept as is
+                    img24 = bmp24_loadFromProbe(&probe);
                     if (!img24) {
-                        printf("Failed to load 24-bit image.\n");
+                        printf("Failed to load %d-bit image.\n", bits);
                         bits = -1;
                     } else {
-                        printf("24-bit image loaded successfully.\n");
+                        printf("%d-bit image loaded successfully.\n", bits);
+                        bits = 24;
                     }
                 } else {
-                    printf("Unsupported format. Only 8-bit and 24-bit BMP files are supported.\n");
+                    bmp_probeClose(&probe);
+                    bits = -1;
+                    printf("Unsupported format. Only 8-bit, 24-bit and 32-bit BMP files are supported.\n");
                 }
                 break;
             }
 
             case 2: {
                 if (bits == 8 && img8) {
+                    char answer[8];
                     printf("Enter output file name: ");
                     scanf("%255s", filepath);
+                    printf("Compress with RLE8 (y/n, worth it for thresholded images): ");
+                    scanf("%7s", answer);
                     getchar();
+                    img8->compression = (answer[0] == 'y' || answer[0] == 'Y') ? BMP8_RLE8 : BMP8_RGB;
                     bmp8_saveImage(filepath, img8);
                 } else if (bits == 24 && img24) {
                     printf("Enter output file name: ");
@@ -341,7 +738,33 @@ int main(void) {
                 }
                 break;
 
-            case 5:
+            case 5: {
+                // The file is reduced while it is read : the current image is left alone
+                t_bmp_probe probe;
+                int maxWidth, maxHeight;
+                printf("Enter file path: ");
+                scanf("%255s", filepath);
+                printf("Largest width and height (e.g. 256 256): ");
+                scanf("%d %d", &maxWidth, &maxHeight);
+                getchar();
+                if (bmp_probe(filepath, &probe) != 0) {
+                    printf("Failed to open the file.\n");
+                    break;
+                }
+                int fileBits = probe.bits;
+                bmp_probeClose(&probe);
+
+                if (fileBits == 8) {
+                    saveNewImage8(bmp8_loadThumbnail(filepath, maxWidth, maxHeight));
+                } else if (fileBits == 24 || fileBits == 32) {
+                    saveNewImage24(bmp24_loadThumbnail(filepath, maxWidth, maxHeight));
+                } else {
+                    printf("Unsupported format. Only 8-bit, 24-bit and 32-bit BMP files are supported.\n");
+                }
+                break;
+            }
+
+            case 6:
                 if (img8) {
                     bmp8_free(img8);
                 }
@@ -352,7 +775,7 @@ int main(void) {
                 return 0;
 
             default:
-                printf("Invalid option. Please choose 1 to 5.\n");
+                printf("Invalid option. Please choose 1 to 6.\n");
         }
     }
 }
@@ -0,0 +1,193 @@
+#include "median.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// -------------------- HEADER ---------------------------
+//  Name : median.c
+//  Goal : O(1) median filter (Perreault & Hebert) : one histogram per column, slid down the image,
+//         and a window histogram slid along each row by adding/removing whole column histograms
+//  Authors : Amel Boulhamane and Tom Hausmann
+// 
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments 
+//
+// --------------------------------------------------------
+
+
+// Histograms are split in 16 coarse bins (high nibble) of 16 fine bins (low nibble), so finding the
+// median only needs to look at 16 + 16 counters instead of 256.
+#define COARSE 16
+#define FINE 256
+
+
+/// @brief Clamps a coordinate into [0, size - 1] (edge pixels are replicated outside the image).
+static int clampIndex(int i, int size) {
+    return i < 0 ? 0 : (i >= size ? size - 1 : i);
+}
+
+
+/// @brief Adds (sign = 1) or removes (sign = -1) one column histogram to/from the window histogram.
+/// These fixed-length loops have no dependencies between iterations and are vectorized by the compiler.
+static void histUpdate(uint32_t *fine, uint32_t *coarse, const uint16_t *colFine, const uint16_t *colCoarse, int sign) {
+    if (sign > 0) {
+        for (int i = 0; i < FINE; i++) fine[i] += colFine[i];
+        for (int i = 0; i < COARSE; i++) coarse[i] += colCoarse[i];
+    } else {
+        for (int i = 0; i < FINE; i++) fine[i] -= colFine[i];
+        for (int i = 0; i < COARSE; i++) coarse[i] -= colCoarse[i];
+    }
+}
+
+
+/// @brief Finds the value of the given rank (0 = smallest) in the window histogram.
+static uint8_t histRank(const uint32_t *fine, const uint32_t *coarse, uint32_t rank) {
+    int c = 0;
+    while (rank >= coarse[c]) {
+        rank -= coarse[c];
+        c++;
+    }
+    const uint32_t *bins = fine + c * 16;
+    int f = 0;
+    while (rank >= bins[f]) {
+        rank -= bins[f];
+        f++;
+    }
+    return (uint8_t)(c * 16 + f);
+}
+
+
+/// @brief Filters the rows [y0, y1[ of the image. Each band keeps its own column histograms so bands
+/// can run in parallel.
+/// @return 0 on success, -1 if the histograms cannot be allocated.
+static int medianBand(t_plane *src, t_plane *dst, int radius, int y0, int y1) {
+    int w = src->width, h = src->height, step = src->step;
+    uint16_t *colFine = (uint16_t *)calloc((size_t)w * FINE, sizeof(uint16_t));
+    uint16_t *colCoarse = (uint16_t *)calloc((size_t)w * COARSE, sizeof(uint16_t));
+    if (!colFine || !colCoarse) {
+        free(colFine);
+        free(colCoarse);
+        return -1;
+    }
+
+    // Column histograms for the window of the first row of the band
+    for (int dy = -radius; dy <= radius; dy++) {
+        const uint8_t *row = src->rows[clampIndex(y0 + dy, h)];
+        for (int x = 0; x < w; x++) {
+            uint8_t v = row[x * step];
+            colFine[x * FINE + v]++;
+            colCoarse[x * COARSE + (v >> 4)]++;
+        }
+    }
+
+    uint32_t rank = ((uint32_t)(2 * radius + 1) * (2 * radius + 1)) / 2;
+    uint32_t fine[FINE], coarse[COARSE];
+
+    for (int y = y0; y < y1; y++) {
+        // Slide every column histogram one row down
+        if (y > y0) {
+            const uint8_t *out = src->rows[clampIndex(y - radius - 1, h)];
+            const uint8_t *in = src->rows[clampIndex(y + radius, h)];
+            for (int x = 0; x < w; x++) {
+                uint8_t vo = out[x * step], vi = in[x * step];
+                colFine[x * FINE + vo]--;
+                colCoarse[x * COARSE + (vo >> 4)]--;
+                colFine[x * FINE + vi]++;
+                colCoarse[x * COARSE + (vi >> 4)]++;
+            }
+        }
+
+        // Window histogram of the first pixel of the row
+        memset(fine, 0, sizeof(fine));
+        memset(coarse, 0, sizeof(coarse));
+        for (int dx = -radius; dx <= radius; dx++) {
+            int c = clampIndex(dx, w);
+            histUpdate(fine, coarse, colFine + c * FINE, colCoarse + c * COARSE, 1);
+        }
+
+        uint8_t *outRow = dst->rows[y];
+        for (int x = 0; x < w; x++) {
+            outRow[x * dst->step] = histRank(fine, coarse, rank);
+
+            // Slide the window one column to the right
+            int cin = clampIndex(x + radius + 1, w), cout = clampIndex(x - radius, w);
+            if (cin != cout) {
+                histUpdate(fine, coarse, colFine + cin * FINE, colCoarse + cin * COARSE, 1);
+                histUpdate(fine, coarse, colFine + cout * FINE, colCoarse + cout * COARSE, -1);
+            }
+        }
+    }
+
+    free(colFine);
+    free(colCoarse);
+    return 0;
+}
+
+
+/// @brief Median filter of a channel. The cost per pixel does not depend on the radius. The image is
+/// cut into horizontal bands, one per thread when OpenMP is enabled.
+/// @param src Source channel.
+/// @param dst Destination channel, same dimensions as src.
+/// @param radius Radius of the square window (1 gives a 3x3 window).
+/// @return 0 on success, -1 on error.
+int plane_median(t_plane *src, t_plane *dst, int radius) {
+    if (!src || !dst || radius < 0 || radius > 32767) return -1;
+    if (src->width != dst->width || src->height != dst->height) return -1;
+
+    int bands = 1;
+#ifdef _OPENMP
+    bands = omp_get_max_threads();
+#endif
+    if (bands > src->height) bands = src->height;
+    int bandHeight = (src->height + bands - 1) / bands;
+    int failed = 0;
+
+    #pragma omp parallel for reduction(|:failed)
+    for (int b = 0; b < bands; b++) {
+        int y0 = b * bandHeight;
+        int y1 = y0 + bandHeight > src->height ? src->height : y0 + bandHeight;
+        if (y0 < y1 && medianBand(src, dst, radius, y0, y1) != 0) failed = 1;
+    }
+
+    if (failed) {
+        fprintf(stderr, "Memory allocation failed for median histograms.\n");
+        return -1;
+    }
+    return 0;
+}
+
+
+/// @brief Filters one channel in place: the source pixels are copied first.
+static void medianInPlace(t_plane *plane, int radius) {
+    t_plane copy;
+    if (plane_copy(plane, &copy) != 0) return;
+    plane_median(&copy, plane, radius);
+    plane_free(&copy);
+}
+
+
+/// @brief Applies a median filter to an 8-bit image, removes salt-and-pepper noise.
+/// @param img 8-bit image to denoise.
+/// @param radius Radius of the square window (1 gives a 3x3 window).
+void bmp8_median(t_bmp8 *img, int radius) {
+    t_plane plane;
+    if (plane_fromBmp8(img, &plane) != 0) return;
+    medianInPlace(&plane, radius);
+    plane_free(&plane);
+}
+
+
+/// @brief Applies a median filter to each channel of a 24-bit image.
+/// @param img 24-bit image to denoise.
+/// @param radius Radius of the square window (1 gives a 3x3 window).
+void bmp24_median(t_bmp24 *img, int radius) {
+    for (int c = 0; c < 3; c++) {
+        t_plane plane;
+        if (plane_fromBmp24(img, c, &plane) != 0) return;
+        medianInPlace(&plane, radius);
+        plane_free(&plane);
+    }
+}
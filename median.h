@@ -0,0 +1,25 @@
+#ifndef MEDIAN_H
+#define MEDIAN_H
+
+#include "bmp8.h"
+#include "bmp24.h"
+#include "plane.h"
+
+// -------------------- HEADER ---------------------------
+//  Name : median.h
+//  Goal : constant-time median filter of any radius (histogram based) for 8-bit and 24-bit images
+//  Authors : Amel Boulhamane and Tom Hausmann
+// 
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments 
+//
+// --------------------------------------------------------
+
+
+// Median of the (2 * radius + 1)^2 window of src written into dst (same size, different pixels)
+int plane_median(t_plane *src, t_plane *dst, int radius);
+
+// In-place median filters, borders are handled by replicating the edge pixels
+void bmp8_median(t_bmp8 *img, int radius);
+void bmp24_median(t_bmp24 *img, int radius);
+
+#endif // MEDIAN_H
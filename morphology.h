@@ -0,0 +1,37 @@
+#ifndef MORPHOLOGY_H
+#define MORPHOLOGY_H
+
+#include "bmp8.h"
+#include "bmp24.h"
+#include "plane.h"
+
+// -------------------- HEADER ---------------------------
+//  Name : morphology.h
+//  Goal : erosion, dilation, opening, closing and top-hats with rectangular structuring elements
+//  Authors : Amel Boulhamane and Tom Hausmann
+// 
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments 
+//
+// --------------------------------------------------------
+
+
+typedef enum {
+    MORPH_ERODE,
+    MORPH_DILATE,
+    MORPH_OPEN,       // erode then dilate : removes bright details smaller than the element
+    MORPH_CLOSE,      // dilate then erode : fills dark details smaller than the element
+    MORPH_TOPHAT,     // image - opening : keeps only the bright details removed by the opening
+    MORPH_BLACKHAT    // closing - image : keeps only the dark details filled by the closing
+} t_morph_op;
+
+// Gray-level morphology, constant cost per pixel whatever the element size (van Herk / Gil-Werman)
+int plane_morphology(t_plane *plane, int seWidth, int seHeight, t_morph_op op);
+
+// Binary morphology on 1 bit per pixel (pixels >= 128 are foreground), results are 0 / 255
+int plane_binaryMorphology(t_plane *plane, int seWidth, int seHeight, t_morph_op op);
+
+// bmp8_morphology switches to the bit-packed path by itself when the image only holds 0 and 255
+void bmp8_morphology(t_bmp8 *img, int seWidth, int seHeight, t_morph_op op);
+void bmp24_morphology(t_bmp24 *img, int seWidth, int seHeight, t_morph_op op);
+
+#endif // MORPHOLOGY_H
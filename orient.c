@@ -0,0 +1,249 @@
+#include "orient.h"
+#include "image.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+// -------------------- HEADER ---------------------------
+//  Name : orient.c
+//  Goal : rotations by quarter turns, flips and transpositions of 8-bit and 24-bit images
+//  Authors : Amel Boulhamane and Tom Hausmann
+//
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments
+//
+// --------------------------------------------------------
+//
+// Quarter turns and transpositions read the columns of the image : done naively, every output pixel
+// touches a new cache line. They are done tile by tile instead, so the source rows of a tile stay in cache
+// while its output rows are written. Vertical flips only move rows : an 8-bit image flips its row order
+// flag, an interleaved 24-bit image swaps its row pointers, no pixel is copied.
+
+
+// Side of the square tiles, in pixels : a tile of 4-byte pixels is 16 KB, read and written within L1
+#define ORIENT_TILE 64
+
+
+/// @brief Tells whether an operation exchanges the width and the height.
+static int swapsAxes(t_orient op) {
+    return op == ORIENT_ROTATE_90 || op == ORIENT_ROTATE_270 || op == ORIENT_TRANSPOSE || op == ORIENT_TRANSVERSE;
+}
+
+
+// One instance of the tile copy per pixel size, so the pixel copy is a fixed-size move. Output pixel (dx, dy)
+// is source pixel (dy or width - 1 - dy, dx or height - 1 - dx) : the source column is fixed along an output row.
+#define ORIENT_TILE_COPY(name, ES)                                                                      \
+static void name(const t_image *src, const t_image *dst, int group, int x0, int y0, int x1, int y1,      \
+                 int reverseX, int reverseY) {                                                           \
+    uint8_t *const *srcRows = src->rows + (size_t)group * src->height;                                  \
+    for (int dy = y0; dy < y1; dy++) {                                                                  \
+        int sx = reverseX ? src->width - 1 - dy : dy;                                                   \
+        uint8_t *out = dst->rows[(size_t)group * dst->height + dy];                                     \
+        for (int dx = x0; dx < x1; dx++) {                                                              \
+            int sy = reverseY ? src->height - 1 - dx : dx;                                              \
+            memcpy(out + (size_t)dx * (ES), srcRows[sy] + (size_t)sx * (ES), (ES));                     \
+        }                                                                                               \
+    }                                                                                                   \
+}
+
+ORIENT_TILE_COPY(tileCopy1, 1)
+ORIENT_TILE_COPY(tileCopy3, 3)
+ORIENT_TILE_COPY(tileCopy4, 4)
+
+
+/// @brief Writes a quarter turn or transposition of the source pixels into the output pixels, tile by tile.
+/// @param src Source pixels.
+/// @param dst Output pixels : same format, width and height exchanged.
+/// @param op ORIENT_ROTATE_90, ORIENT_ROTATE_270, ORIENT_TRANSPOSE or ORIENT_TRANSVERSE.
+static void transposeView(const t_image *src, const t_image *dst, t_orient op) {
+    int reverseX = (op == ORIENT_ROTATE_270 || op == ORIENT_TRANSVERSE);
+    int reverseY = (op == ORIENT_ROTATE_90 || op == ORIENT_TRANSVERSE);
+    int tileRows = (dst->height + ORIENT_TILE - 1) / ORIENT_TILE;
+    int es = src->pixelStep;
+
+    #pragma omp parallel for
+    for (int t = 0; t < dst->groups * tileRows; t++) {
+        int group = t / tileRows;
+        int y0 = (t % tileRows) * ORIENT_TILE;
+        int y1 = y0 + ORIENT_TILE < dst->height ? y0 + ORIENT_TILE : dst->height;
+        for (int x0 = 0; x0 < dst->width; x0 += ORIENT_TILE) {
+            int x1 = x0 + ORIENT_TILE < dst->width ? x0 + ORIENT_TILE : dst->width;
+            if (es == 1) tileCopy1(src, dst, group, x0, y0, x1, y1, reverseX, reverseY);
+            else if (es == 3) tileCopy3(src, dst, group, x0, y0, x1, y1, reverseX, reverseY);
+            else tileCopy4(src, dst, group, x0, y0, x1, y1, reverseX, reverseY);
+        }
+    }
+}
+
+
+// One instance of the row mirror per pixel size
+#define ORIENT_MIRROR_ROW(name, ES)                                  \
+static void name(uint8_t *row, int width) {                          \
+    uint8_t tmp[4];                                                  \
+    for (int x = 0, y = width - 1; x < y; x++, y--) {                \
+        memcpy(tmp, row + (size_t)x * (ES), (ES));                   \
+        memcpy(row + (size_t)x * (ES), row + (size_t)y * (ES), (ES)); \
+        memcpy(row + (size_t)y * (ES), tmp, (ES));                   \
+    }                                                                \
+}
+
+ORIENT_MIRROR_ROW(mirrorRow1, 1)
+ORIENT_MIRROR_ROW(mirrorRow3, 3)
+ORIENT_MIRROR_ROW(mirrorRow4, 4)
+
+
+/// @brief Mirrors every row of a descriptor left-right, in place.
+static void flipHorizontal(const t_image *view) {
+    int rows = view->groups * view->height;
+    #pragma omp parallel for
+    for (int r = 0; r < rows; r++) {
+        if (view->pixelStep == 1) mirrorRow1(view->rows[r], view->width);
+        else if (view->pixelStep == 3) mirrorRow3(view->rows[r], view->width);
+        else mirrorRow4(view->rows[r], view->width);
+    }
+}
+
+
+/// @brief Turns a descriptor upside down by exchanging the bytes of its rows, in place (for the layouts
+/// whose rows can't be reordered without moving them).
+/// @return 0 on success, -1 if memory allocation fails.
+static int flipVertical(const t_image *view) {
+    size_t bytes = (size_t)view->width * view->pixelStep;
+    int half = view->height / 2;
+    int failed = 0;
+
+    #pragma omp parallel
+    {
+        uint8_t *tmp = (uint8_t *)malloc(bytes);
+        if (!tmp) {
+            #pragma omp atomic write
+            failed = 1;
+        }
+        #pragma omp for
+        for (int r = 0; r < view->groups * half; r++) {
+            if (!tmp) continue;
+            uint8_t *const *group = view->rows + (size_t)(r / half) * view->height;
+            int y = r % half;
+            memcpy(tmp, group[y], bytes);
+            memcpy(group[y], group[view->height - 1 - y], bytes);
+            memcpy(group[view->height - 1 - y], tmp, bytes);
+        }
+        free(tmp);
+    }
+    if (failed) fprintf(stderr, "Memory allocation failed for flip.\n");
+    return failed ? -1 : 0;
+}
+
+
+/// @brief Rotates, flips or transposes an 8-bit image in place. The vertical flip (and the vertical half of
+/// the 180 degree rotation) only reverses the row order flag of the image : no pixel is moved, and the image
+/// is saved with the other row order. Quarter turns and transpositions reallocate the pixels.
+/// @param img Image to modify.
+/// @param op Operation.
+/// @return 0 on success, -1 on error (the image is left unchanged).
+int bmp8_orient(t_bmp8 *img, t_orient op) {
+    if (!img || !img->data || op < ORIENT_ROTATE_90 || op > ORIENT_TRANSVERSE) return -1;
+
+    t_image view;
+    if (!swapsAxes(op)) {
+        if (op == ORIENT_FLIP_VERTICAL || op == ORIENT_ROTATE_180) img->topDown = !img->topDown;
+        if (op == ORIENT_FLIP_HORIZONTAL || op == ORIENT_ROTATE_180) {
+            if (image_fromBmp8(img, &view) != 0) return -1;
+            flipHorizontal(&view);
+            image_free(&view);
+        }
+        return 0;
+    }
+
+    t_bmp8 *out = bmp8_allocate(img->height, img->width);
+    if (!out) return -1;
+    t_image outView;
+    if (image_fromBmp8(img, &view) != 0) {
+        bmp8_free(out);
+        return -1;
+    }
+    if (image_fromBmp8(out, &outView) != 0) {
+        image_free(&view);
+        bmp8_free(out);
+        return -1;
+    }
+    transposeView(&view, &outView, op);
+    image_free(&view);
+    image_free(&outView);
+
+    // The image takes the new pixels, the stored row order of out (bottom-up) included
+    if (!img->aliased) free(img->data);
+    img->data = out->data;
+    img->width = out->width;
+    img->height = out->height;
+    img->stride = out->stride;
+    img->dataSize = out->dataSize;
+    img->topDown = out->topDown;
+    img->aliased = 0;
+    out->data = NULL;
+    bmp8_free(out);
+    return 0;
+}
+
+
+/// @brief Rotates, flips or transposes a 24-bit image in place, whatever its layout (the alpha of BGRA
+/// pixels follows its pixel). The vertical flip of an interleaved image only swaps its row pointers; the
+/// planar and BGRA layouts store their rows at fixed strides, so their rows are exchanged. Quarter turns
+/// and transpositions reallocate the pixels, in the same layout.
+/// @param img Image to modify.
+/// @param op Operation.
+/// @return 0 on success, -1 on error (the image is left unchanged).
+int bmp24_orient(t_bmp24 *img, t_orient op) {
+    if (!img || op < ORIENT_ROTATE_90 || op > ORIENT_TRANSVERSE) return -1;
+
+    t_image view;
+    if (!swapsAxes(op)) {
+        if (image_fromBmp24(img, &view) != 0) return -1;
+        int status = 0;
+        if (op == ORIENT_FLIP_VERTICAL || op == ORIENT_ROTATE_180) {
+            if (img->layout == BMP24_INTERLEAVED) {
+                for (int y = 0, z = img->height - 1; y < z; y++, z--) {
+                    t_pixel *row = img->data[y];
+                    img->data[y] = img->data[z];
+                    img->data[z] = row;
+                }
+                // The descriptor was built before the swap
+                for (int y = 0; y < img->height; y++) view.rows[y] = (uint8_t *)img->data[y];
+            } else {
+                status = flipVertical(&view);
+            }
+        }
+        if (status == 0 && (op == ORIENT_FLIP_HORIZONTAL || op == ORIENT_ROTATE_180)) flipHorizontal(&view);
+        image_free(&view);
+        return status;
+    }
+
+    t_bmp24 *out = bmp24_allocateLayout(img->height, img->width, img->colorDepth, img->layout);
+    if (!out) return -1;
+    out->header = img->header;
+    out->header_info = img->header_info;
+    out->topDown = img->topDown;
+    out->header_info.width = out->width;
+    out->header_info.height = out->topDown ? -out->height : out->height;
+
+    t_image outView;
+    if (image_fromBmp24(img, &view) != 0) {
+        bmp24_free(out);
+        return -1;
+    }
+    if (image_fromBmp24(out, &outView) != 0) {
+        image_free(&view);
+        bmp24_free(out);
+        return -1;
+    }
+    transposeView(&view, &outView, op);
+    image_free(&view);
+    image_free(&outView);
+
+    // The image takes the new pixels, and out the old ones, freed with it
+    t_bmp24 old = *img;
+    *img = *out;
+    *out = old;
+    bmp24_free(out);
+    return 0;
+}
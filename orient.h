@@ -0,0 +1,30 @@
+#ifndef ORIENT_H
+#define ORIENT_H
+
+#include "bmp8.h"
+#include "bmp24.h"
+
+// -------------------- HEADER ---------------------------
+//  Name : orient.h
+//  Goal : rotations by quarter turns, flips and transpositions of 8-bit and 24-bit images
+//  Authors : Amel Boulhamane and Tom Hausmann
+//
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments
+//
+// --------------------------------------------------------
+
+
+typedef enum {
+    ORIENT_ROTATE_90,         // quarter turn clockwise
+    ORIENT_ROTATE_180,
+    ORIENT_ROTATE_270,        // quarter turn counter-clockwise
+    ORIENT_FLIP_HORIZONTAL,   // mirror left-right
+    ORIENT_FLIP_VERTICAL,     // upside down
+    ORIENT_TRANSPOSE,         // mirror along the main diagonal (top-left to bottom-right)
+    ORIENT_TRANSVERSE         // mirror along the other diagonal
+} t_orient;
+
+int bmp8_orient(t_bmp8 *img, t_orient op);
+int bmp24_orient(t_bmp24 *img, t_orient op);
+
+#endif // ORIENT_H
@@ -0,0 +1,126 @@
+#include "plane.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// -------------------- HEADER ---------------------------
+//  Name : plane.c
+//  Goal : build single-channel views (row pointers + sample step) over 8-bit and 24-bit images
+//  Authors : Amel Boulhamane and Tom Hausmann
+// 
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments 
+//
+// --------------------------------------------------------
+
+
+/// @brief Allocates the row pointer array of a plane.
+/// @param plane Plane to initialize.
+/// @param width Width of the plane in samples.
+/// @param height Height of the plane in rows.
+/// @return 0 on success, -1 if the allocation fails.
+static int plane_allocate(t_plane *plane, int width, int height) {
+    plane->rows = (uint8_t **)malloc(height * sizeof(uint8_t *));
+    if (!plane->rows) {
+        fprintf(stderr, "Memory allocation failed for plane rows.\n");
+        return -1;
+    }
+    plane->width = width;
+    plane->height = height;
+    plane->owned = NULL;
+    return 0;
+}
+
+
+/// @brief Builds a view over one channel of an image descriptor. The row addressing of each layout is the
+/// one of the descriptor, so a plane is always one channel of what image_fromBmp8 or image_fromBmp24 see.
+/// @param view Descriptor filled by image_fromBmp8 or image_fromBmp24.
+/// @param channel PLANE_RED, PLANE_GREEN or PLANE_BLUE for 24-bit descriptors, 0 for 8-bit ones.
+/// @param plane Plane to fill.
+/// @return 0 on success, -1 on error.
+int plane_fromImage(const t_image *view, int channel, t_plane *plane) {
+    if (!view || !view->rows || !plane) return -1;
+
+    int channels = view->format == IMAGE_GRAY8 ? 1 : 3;
+    if (channel < 0 || channel >= channels) {
+        fprintf(stderr, "Invalid channel %d.\n", channel);
+        return -1;
+    }
+    if (plane_allocate(plane, view->width, view->height) != 0) return -1;
+
+    if (view->format == IMAGE_GRAY8) {
+        plane->step = view->pixelStep;
+        for (int y = 0; y < view->height; y++) plane->rows[y] = view->rows[y];
+        return 0;
+    }
+    for (int y = 0; y < view->height; y++) {
+        uint8_t *rgb[3];
+        plane->step = image_rgbRow(view, y, rgb);
+        plane->rows[y] = rgb[channel];
+    }
+    return 0;
+}
+
+
+/// @brief Builds a view over the pixels of an 8-bit image, in place over its padded rows. Row 0 of the
+/// plane is the top of the image, whatever the orientation of the file.
+/// @param img 8-bit image to view.
+/// @param plane Plane to fill.
+/// @return 0 on success, -1 on error.
+int plane_fromBmp8(t_bmp8 *img, t_plane *plane) {
+    t_image view;
+    if (image_fromBmp8(img, &view) != 0) return -1;
+    int status = plane_fromImage(&view, 0, plane);
+    image_free(&view);
+    return status;
+}
+
+
+/// @brief Builds a view over one color channel of a 24-bit image (interleaved, planar or BGRA).
+/// @param img 24-bit image to view.
+/// @param channel PLANE_RED, PLANE_GREEN or PLANE_BLUE.
+/// @param plane Plane to fill.
+/// @return 0 on success, -1 on error.
+int plane_fromBmp24(t_bmp24 *img, int channel, t_plane *plane) {
+    t_image view;
+    if (image_fromBmp24(img, &view) != 0) return -1;
+    int status = plane_fromImage(&view, channel, plane);
+    image_free(&view);
+    return status;
+}
+
+
+/// @brief Copies a channel into a new packed buffer (step 1), e.g. to keep the source pixels of a
+/// filter that writes its result back into the image.
+/// @param src Plane to copy.
+/// @param copy Plane to fill, it owns its pixels and must be released with plane_free.
+/// @return 0 on success, -1 on error.
+int plane_copy(t_plane *src, t_plane *copy) {
+    if (!src || !src->rows || !copy) return -1;
+
+    if (plane_allocate(copy, src->width, src->height) != 0) return -1;
+    copy->step = 1;
+    copy->owned = (uint8_t *)malloc((size_t)src->width * src->height);
+    if (!copy->owned) {
+        fprintf(stderr, "Memory allocation failed for plane copy.\n");
+        plane_free(copy);
+        return -1;
+    }
+
+    for (int y = 0; y < src->height; y++) {
+        copy->rows[y] = copy->owned + (size_t)y * src->width;
+        for (int x = 0; x < src->width; x++) {
+            copy->rows[y][x] = src->rows[y][x * src->step];
+        }
+    }
+    return 0;
+}
+
+
+/// @brief Frees the row pointer array of a plane, and its pixels if it owns them.
+/// @param plane Plane to release.
+void plane_free(t_plane *plane) {
+    if (!plane) return;
+    free(plane->rows);
+    free(plane->owned);
+    plane->rows = NULL;
+    plane->owned = NULL;
+}
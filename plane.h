@@ -0,0 +1,41 @@
+#ifndef PLANE_H
+#define PLANE_H
+
+#include <stdint.h>
+#include "bmp8.h"
+#include "bmp24.h"
+#include "image.h"
+
+// -------------------- HEADER ---------------------------
+//  Name : plane.h
+//  Goal : single-channel views over 8-bit and 24-bit images, so per-channel operators are written only once
+//  Authors : Amel Boulhamane and Tom Hausmann
+// 
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments 
+//
+// --------------------------------------------------------
+
+
+// Channel indices for plane_fromBmp24
+#define PLANE_RED   0
+#define PLANE_GREEN 1
+#define PLANE_BLUE  2
+
+// A view over one channel of an image : a t_image whose rows point at a single channel, for the operators
+// that run on each channel separately (integral images, median, rank and morphology, histograms).
+// It does not own the pixels, only the row pointer array.
+typedef struct {
+    uint8_t **rows;   // One pointer per row, the top row of the image first
+    int width;
+    int height;
+    int step;         // Number of bytes between two horizontally adjacent samples of the channel
+    uint8_t *owned;   // Pixel buffer owned by the plane (only for copies made by plane_copy), NULL for views
+} t_plane;
+
+int plane_fromImage(const t_image *view, int channel, t_plane *plane);
+int plane_fromBmp8(t_bmp8 *img, t_plane *plane);
+int plane_fromBmp24(t_bmp24 *img, int channel, t_plane *plane);
+int plane_copy(t_plane *src, t_plane *copy);
+void plane_free(t_plane *plane);
+
+#endif // PLANE_H
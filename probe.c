@@ -0,0 +1,100 @@
+#include "probe.h"
+#include <string.h>
+
+// -------------------- HEADER ---------------------------
+//  Name : probe.c
+//  Goal : parse the headers of BMP files with a single read, for fast metadata scans
+//  Authors : Amel Boulhamane and Tom Hausmann
+// 
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments 
+//
+// --------------------------------------------------------
+
+
+/// @brief Decodes the 54 bytes of the file header and info header.
+/// @param raw The bytes, as stored at the start of the file.
+/// @param header @param info Receive the decoded fields.
+/// @return 0 on success, -1 if the bytes are not the start of a BMP file.
+int bmp_parseHeader(const unsigned char raw[BMP_HEADER_SIZE], t_bmp_header *header, t_bmp_info *info) {
+    if (raw[0] != 'B' || raw[1] != 'M') {
+        fprintf(stderr, "Not a valid BMP file (missing 'BM' signature).\n");
+        return -1;
+    }
+
+    // Fields are little-endian and packed, as in the file
+    memcpy(&header->type, raw + 0, 2);
+    memcpy(&header->size, raw + 2, 4);
+    memcpy(&header->reserved1, raw + 6, 2);
+    memcpy(&header->reserved2, raw + 8, 2);
+    memcpy(&header->offset, raw + 10, 4);
+
+    memcpy(&info->size, raw + 14, 4);
+    memcpy(&info->width, raw + 18, 4);
+    memcpy(&info->height, raw + 22, 4);
+    memcpy(&info->planes, raw + 26, 2);
+    memcpy(&info->bits, raw + 28, 2);
+    memcpy(&info->compression, raw + 30, 4);
+    memcpy(&info->imagesize, raw + 34, 4);
+    memcpy(&info->xresolution, raw + 38, 4);
+    memcpy(&info->yresolution, raw + 42, 4);
+    memcpy(&info->ncolors, raw + 46, 4);
+    memcpy(&info->importantcolors, raw + 50, 4);
+    return 0;
+}
+
+
+/// @brief Reads the 54 bytes of the file header and info header in one read and decodes them.
+/// @param file File positioned at its start.
+/// @param raw Receives the bytes read.
+/// @param header @param info Receive the decoded fields.
+/// @return 0 on success, -1 if the file is too short or is not a BMP file.
+int bmp_readHeader(FILE *file, unsigned char raw[BMP_HEADER_SIZE], t_bmp_header *header, t_bmp_info *info) {
+    if (fread(raw, 1, BMP_HEADER_SIZE, file) != BMP_HEADER_SIZE) {
+        fprintf(stderr, "Error reading BMP header\n");
+        return -1;
+    }
+    return bmp_parseHeader(raw, header, info);
+}
+
+
+/// @brief Opens a BMP file and reads its headers only. The file stays open so that the image can be loaded
+/// with bmp8_loadFromProbe or bmp24_loadFromProbe without opening and parsing it again.
+/// @param filename Path to the BMP file.
+/// @param probe Receives the headers and the open file. Close it with bmp_probeClose if the image isn't loaded.
+/// @return 0 on success, -1 if the file can't be opened or is not a BMP file (nothing is left open then).
+int bmp_probe(const char *filename, t_bmp_probe *probe) {
+    memset(probe, 0, sizeof(*probe));
+    probe->file = fopen(filename, "rb");
+    if (!probe->file) {
+        fprintf(stderr, "Error opening file %s\n", filename);
+        return -1;
+    }
+    // Unbuffered : the headers are a single read of their 54 bytes, nothing more is fetched for a metadata scan.
+    // The loaders then read the pixels of this file by whole rows, strips or chunks.
+    setvbuf(probe->file, NULL, _IONBF, 0);
+
+    if (bmp_readHeader(probe->file, probe->raw, &probe->header, &probe->info) != 0) {
+        bmp_probeClose(probe);
+        return -1;
+    }
+
+    probe->width = probe->info.width;
+    probe->topDown = probe->info.height < 0;
+    probe->height = probe->topDown ? -probe->info.height : probe->info.height;
+    probe->bits = probe->info.bits;
+    probe->compression = probe->info.compression;
+    probe->offset = probe->header.offset;
+    probe->paletteColors = probe->info.ncolors;
+    if (probe->paletteColors == 0 && probe->bits <= 8) probe->paletteColors = 1u << probe->bits;
+    return 0;
+}
+
+
+/// @brief Closes the file of a probe, if it is still open.
+/// @param probe The probe.
+void bmp_probeClose(t_bmp_probe *probe) {
+    if (probe && probe->file) {
+        fclose(probe->file);
+        probe->file = NULL;
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef PROBE_H
+#define PROBE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "bmp8.h"
+#include "bmp24.h"
+
+// -------------------- HEADER ---------------------------
+//  Name : probe.h
+//  Goal : read the headers of a BMP file without touching its pixels, and load it later from the same open file
+//  Authors : Amel Boulhamane and Tom Hausmann
+// 
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments 
+//
+// --------------------------------------------------------
+
+
+// Size of the file header and of the BITMAPINFOHEADER, read at once
+#define BMP_HEADER_SIZE 54
+
+// Bytes of pixel rows read or written at once by the 24-bit loaders and savers : the rows are accessed
+// sequentially, so whole strips of rows turn them into few big reads and writes (faster on network filesystems)
+#define BMP_IO_STRIP (1 << 20)
+
+// Everything the headers of a BMP file tell
+typedef struct {
+    FILE *file;               // Left open for bmp8_loadFromProbe / bmp24_loadFromProbe, NULL once closed
+    unsigned char raw[BMP_HEADER_SIZE]; // The bytes read
+    t_bmp_header header;
+    t_bmp_info info;
+    int width;
+    int height;               // Always positive
+    int topDown;              // 1 if the rows are stored from the top (negative height in the file)
+    int bits;                 // 8, 24, 32... as written in the file
+    uint32_t compression;
+    uint32_t offset;          // Start of the pixels
+    uint32_t paletteColors;   // Entries of the color table (the whole 2^bits table when the file gives 0)
+} t_bmp_probe;
+
+
+int bmp_parseHeader(const unsigned char raw[BMP_HEADER_SIZE], t_bmp_header *header, t_bmp_info *info);
+int bmp_readHeader(FILE *file, unsigned char raw[BMP_HEADER_SIZE], t_bmp_header *header, t_bmp_info *info);
+int bmp_probe(const char *filename, t_bmp_probe *probe);
+void bmp_probeClose(t_bmp_probe *probe);
+t_bmp8 *bmp8_loadFromProbe(t_bmp_probe *probe);
+t_bmp24 *bmp24_loadFromProbe(t_bmp_probe *probe);
+
+#endif // PROBE_H
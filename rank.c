@@ -0,0 +1,190 @@
+#include "rank.h"
+#include "plane.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+// -------------------- HEADER ---------------------------
+//  Name : rank.c
+//  Goal : small-window rank filters. The window samples of CHUNK consecutive bytes are loaded into
+//         CHUNK-wide arrays and the sorting network is applied column by column with min/max only, so
+//         the compiler turns each comparator into packed unsigned byte min/max instructions.
+//  Authors : Amel Boulhamane and Tom Hausmann
+// 
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments 
+//
+// --------------------------------------------------------
+
+
+// Number of bytes processed together (two AVX2 registers, four SSE2 registers)
+#define CHUNK 64
+
+// Median selection networks (Paeth / Devillard), the median ends up in wire 4 and wire 12
+static const uint8_t median9[][2] = {
+    {1, 2}, {4, 5}, {7, 8}, {0, 1}, {3, 4}, {6, 7}, {1, 2}, {4, 5}, {7, 8}, {0, 3},
+    {5, 8}, {4, 7}, {3, 6}, {1, 4}, {2, 5}, {4, 7}, {4, 2}, {6, 4}, {4, 2}
+};
+
+static const uint8_t median25[][2] = {
+    {0, 1}, {3, 4}, {2, 4}, {2, 3}, {6, 7}, {5, 7}, {5, 6}, {9, 10}, {8, 10}, {8, 9},
+    {12, 13}, {11, 13}, {11, 12}, {15, 16}, {14, 16}, {14, 15}, {18, 19}, {17, 19}, {17, 18}, {21, 22},
+    {20, 22}, {20, 21}, {23, 24}, {2, 5}, {3, 6}, {0, 6}, {0, 3}, {4, 7}, {1, 7}, {1, 4},
+    {11, 14}, {8, 14}, {8, 11}, {12, 15}, {9, 15}, {9, 12}, {13, 16}, {10, 16}, {10, 13}, {20, 23},
+    {17, 23}, {17, 20}, {21, 24}, {18, 24}, {18, 21}, {19, 22}, {8, 17}, {9, 18}, {0, 18}, {0, 9},
+    {10, 19}, {1, 19}, {1, 10}, {11, 20}, {2, 20}, {2, 11}, {12, 21}, {3, 21}, {3, 12}, {13, 22},
+    {4, 22}, {4, 13}, {14, 23}, {5, 23}, {5, 14}, {15, 24}, {6, 24}, {6, 15}, {7, 16}, {7, 19},
+    {13, 21}, {15, 23}, {7, 13}, {7, 15}, {1, 9}, {3, 11}, {5, 17}, {11, 17}, {9, 17}, {4, 10},
+    {6, 12}, {7, 14}, {4, 6}, {4, 7}, {12, 14}, {10, 14}, {6, 7}, {10, 12}, {6, 10}, {6, 17},
+    {12, 17}, {7, 17}, {7, 10}, {12, 18}, {7, 12}, {10, 18}, {12, 20}, {10, 20}, {10, 12}
+};
+
+
+/// @brief One comparator of the network applied to CHUNK lanes: a receives the min, b the max.
+static void sortLanes(uint8_t *restrict a, uint8_t *restrict b) {
+    for (int j = 0; j < CHUNK; j++) {
+        uint8_t lo = a[j] < b[j] ? a[j] : b[j];
+        uint8_t hi = a[j] < b[j] ? b[j] : a[j];
+        a[j] = lo;
+        b[j] = hi;
+    }
+}
+
+
+/// @brief Filters rows of interleaved samples. Horizontally adjacent pixels are pixelBytes apart and
+/// every byte is ranked independently, so all channels of a t_pixel row are processed at once.
+/// @param rows Row pointers (filtered in place).
+/// @param width Width in pixels.
+/// @param height Number of rows.
+/// @param pixelBytes Bytes per pixel (1 for 8-bit, 3 for 24-bit, 4 for BGRA).
+/// @param size Window size, 3 or 5.
+/// @param op Rank to keep.
+static void rankRows(uint8_t **rows, int width, int height, int pixelBytes, int size, t_rank_op op) {
+    int r = size / 2, n = size * size;
+    int rowBytes = width * pixelBytes;
+    size_t padBytes = (size_t)(width + 2 * r) * pixelBytes + CHUNK;
+
+    // Copy of the image with r replicated pixels on each side, and CHUNK bytes of slack at the end of
+    // each row so that the last chunk can always be loaded whole.
+    uint8_t *pad = (uint8_t *)calloc((size_t)height * padBytes, 1);
+    if (!pad) {
+        fprintf(stderr, "Memory allocation failed for rank filter.\n");
+        return;
+    }
+    for (int y = 0; y < height; y++) {
+        uint8_t *p = pad + y * padBytes;
+        for (int k = 0; k < r; k++) {
+            memcpy(p + k * pixelBytes, rows[y], pixelBytes);
+            memcpy(p + (r + width + k) * pixelBytes, rows[y] + (width - 1) * pixelBytes, pixelBytes);
+        }
+        memcpy(p + r * pixelBytes, rows[y], rowBytes);
+    }
+
+    uint8_t v[25][CHUNK];
+    const uint8_t *src[5];
+
+    for (int y = 0; y < height; y++) {
+        for (int dy = 0; dy < size; dy++) {
+            int yy = y + dy - r;
+            yy = yy < 0 ? 0 : (yy >= height ? height - 1 : yy);
+            src[dy] = pad + yy * padBytes;
+        }
+
+        for (int i = 0; i < rowBytes; i += CHUNK) {
+            for (int dy = 0; dy < size; dy++) {
+                for (int dx = 0; dx < size; dx++) {
+                    memcpy(v[dy * size + dx], src[dy] + i + dx * pixelBytes, CHUNK);
+                }
+            }
+
+            uint8_t *result;
+            if (op == RANK_MEDIAN) {
+                if (size == 3) {
+                    for (size_t k = 0; k < sizeof(median9) / sizeof(median9[0]); k++) {
+                        sortLanes(v[median9[k][0]], v[median9[k][1]]);
+                    }
+                    result = v[4];
+                } else {
+                    for (size_t k = 0; k < sizeof(median25) / sizeof(median25[0]); k++) {
+                        sortLanes(v[median25[k][0]], v[median25[k][1]]);
+                    }
+                    result = v[12];
+                }
+            } else {
+                result = v[0];
+                for (int k = 1; k < n; k++) {
+                    if (op == RANK_MIN) {
+                        for (int j = 0; j < CHUNK; j++) result[j] = result[j] < v[k][j] ? result[j] : v[k][j];
+                    } else {
+                        for (int j = 0; j < CHUNK; j++) result[j] = result[j] > v[k][j] ? result[j] : v[k][j];
+                    }
+                }
+            }
+
+            int count = rowBytes - i < CHUNK ? rowBytes - i : CHUNK;
+            memcpy(rows[y] + i, result, count);
+        }
+    }
+
+    free(pad);
+}
+
+
+/// @brief Applies a 3x3 or 5x5 median, min (erosion) or max (dilation) filter to an 8-bit image.
+/// @param img 8-bit image to filter.
+/// @param size Window size, 3 or 5.
+/// @param op RANK_MEDIAN, RANK_MIN or RANK_MAX.
+void bmp8_rankFilter(t_bmp8 *img, int size, t_rank_op op) {
+    if (!img || !img->data || (size != 3 && size != 5)) return;
+
+    t_plane plane;
+    if (plane_fromBmp8(img, &plane) != 0) return;
+    rankRows(plane.rows, plane.width, plane.height, 1, size, op);
+    plane_free(&plane);
+}
+
+
+/// @brief Applies a 3x3 or 5x5 median, min or max filter to each channel of a 24-bit image.
+/// @param img 24-bit image to filter.
+/// @param size Window size, 3 or 5.
+/// @param op RANK_MEDIAN, RANK_MIN or RANK_MAX.
+void bmp24_rankFilter(t_bmp24 *img, int size, t_rank_op op) {
+    if (!img || (size != 3 && size != 5)) return;
+
+    uint8_t **rows = (uint8_t **)malloc(img->height * sizeof(uint8_t *));
+    if (!rows) {
+        fprintf(stderr, "Memory allocation failed for rank filter.\n");
+        return;
+    }
+    if (img->layout == BMP24_PLANAR) {
+        for (int c = 0; c < 3; c++) {
+            for (int y = 0; y < img->height; y++) {
+                rows[y] = img->planes[c] + (size_t)y * img->planeStride;
+            }
+            rankRows(rows, img->width, img->height, 1, size, op);
+        }
+    } else if (img->layout == BMP24_BGRA) {
+        // The alpha bytes are ranked with the colors (4 bytes per pixel keeps the chunks aligned), then restored
+        uint8_t *alpha = (uint8_t *)malloc((size_t)img->width * img->height);
+        if (!alpha) {
+            fprintf(stderr, "Memory allocation failed for rank filter.\n");
+            free(rows);
+            return;
+        }
+        for (int y = 0; y < img->height; y++) {
+            rows[y] = img->bgra + (size_t)y * img->bgraStride;
+            for (int x = 0; x < img->width; x++) alpha[(size_t)y * img->width + x] = rows[y][4 * x + 3];
+        }
+        rankRows(rows, img->width, img->height, 4, size, op);
+        for (int y = 0; y < img->height; y++) {
+            for (int x = 0; x < img->width; x++) rows[y][4 * x + 3] = alpha[(size_t)y * img->width + x];
+        }
+        free(alpha);
+    } else if (img->data) {
+        for (int y = 0; y < img->height; y++) {
+            rows[y] = (uint8_t *)img->data[y];
+        }
+        rankRows(rows, img->width, img->height, sizeof(t_pixel), size, op);
+    }
+    free(rows);
+}
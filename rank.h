@@ -0,0 +1,28 @@
+#ifndef RANK_H
+#define RANK_H
+
+#include "bmp8.h"
+#include "bmp24.h"
+
+// -------------------- HEADER ---------------------------
+//  Name : rank.h
+//  Goal : branch-free 3x3 and 5x5 median / min / max filters built on sorting networks
+//  Authors : Amel Boulhamane and Tom Hausmann
+// 
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments 
+//
+// --------------------------------------------------------
+
+
+// Which value of the sorted window is kept
+typedef enum {
+    RANK_MEDIAN,
+    RANK_MIN,
+    RANK_MAX
+} t_rank_op;
+
+// size must be 3 or 5 (use bmp8_median / bmp24_median from median.h for larger windows)
+void bmp8_rankFilter(t_bmp8 *img, int size, t_rank_op op);
+void bmp24_rankFilter(t_bmp24 *img, int size, t_rank_op op);
+
+#endif // RANK_H
@@ -0,0 +1,425 @@
+#include "resize.h"
+#include "image.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+// -------------------- HEADER ---------------------------
+//  Name : resize.c
+//  Goal : resize 8-bit and 24-bit images with separable fixed-point filters
+//  Authors : Amel Boulhamane and Tom Hausmann
+//
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments
+//
+// --------------------------------------------------------
+//
+// The image is resized along x (every source row becomes a row of the new width), then along y (every
+// output row is a weighted sum of those rows). The weights of each output column and row are computed
+// once, in 14-bit fixed point, and add up exactly to 1 so flat areas stay flat.
+
+
+#define RESIZE_BITS 14
+#define RESIZE_ONE (1 << RESIZE_BITS)
+
+// Weights of one direction
+typedef struct {
+    int *start;         // first source sample of each output sample
+    int *count;         // number of source samples used
+    int16_t *weights;   // maxTaps weights per output sample
+    int maxTaps;
+} t_resize_table;
+
+
+/// @brief Triangle filter (bilinear).
+static double triangleFilter(double x) {
+    x = fabs(x);
+    return x < 1.0 ? 1.0 - x : 0.0;
+}
+
+
+/// @brief Keys cubic filter with a = -0.5 (Catmull-Rom).
+static double cubicFilter(double x) {
+    const double a = -0.5;
+    x = fabs(x);
+    if (x < 1.0) return ((a + 2.0) * x - (a + 3.0)) * x * x + 1.0;
+    if (x < 2.0) return (((x - 5.0) * x + 8.0) * x - 4.0) * a;
+    return 0.0;
+}
+
+
+/// @brief Frees the arrays of a weight table.
+static void freeTable(t_resize_table *t) {
+    free(t->start);
+    free(t->count);
+    free(t->weights);
+}
+
+
+/// @brief Computes the weights of every output sample of one direction.
+/// @param srcSize Number of source samples.
+/// @param dstSize Number of output samples.
+/// @param filter Filter to use.
+/// @param t Table to fill, released with freeTable.
+/// @return 0 on success, -1 if an allocation fails.
+static int buildTable(int srcSize, int dstSize, t_resize_filter filter, t_resize_table *t) {
+    double scale = (double)srcSize / dstSize;
+    // When downscaling, the filters are stretched over the source pixels covered by one output pixel
+    double stretch = scale > 1.0 ? scale : 1.0;
+    double support = 0.5;
+    if (filter == RESIZE_BILINEAR) support = stretch;
+    else if (filter == RESIZE_BICUBIC) support = 2.0 * stretch;
+    else if (filter == RESIZE_AREA) support = scale / 2.0;
+
+    t->maxTaps = filter == RESIZE_NEAREST ? 1 : (int)ceil(2.0 * support) + 2;
+    t->start = (int *)malloc(dstSize * sizeof(int));
+    t->count = (int *)malloc(dstSize * sizeof(int));
+    t->weights = (int16_t *)calloc((size_t)dstSize * t->maxTaps, sizeof(int16_t));
+    double *w = (double *)malloc(t->maxTaps * sizeof(double));
+    if (!t->start || !t->count || !t->weights || !w) {
+        fprintf(stderr, "Memory allocation failed for resize weights.\n");
+        freeTable(t);
+        free(w);
+        return -1;
+    }
+
+    for (int i = 0; i < dstSize; i++) {
+        double center = (i + 0.5) * scale;
+        int16_t *q = t->weights + (size_t)i * t->maxTaps;
+
+        int nearest = (int)center;
+        if (nearest > srcSize - 1) nearest = srcSize - 1;
+        t->start[i] = nearest;
+        t->count[i] = 1;
+        q[0] = RESIZE_ONE;
+        if (filter == RESIZE_NEAREST) continue;
+
+        // Source samples j cover [j, j + 1] ; the ones outside the image are dropped and the rest renormalized
+        int lo = (int)floor(center - support), hi = (int)ceil(center + support);
+        if (lo < 0) lo = 0;
+        if (hi > srcSize) hi = srcSize;
+        if (hi - lo > t->maxTaps) hi = lo + t->maxTaps;
+
+        double sum = 0.0;
+        for (int j = lo; j < hi; j++) {
+            double v;
+            if (filter == RESIZE_AREA) {
+                double a = fmax(j, center - support), b = fmin(j + 1, center + support);
+                v = b > a ? b - a : 0.0;
+            } else {
+                double x = (j + 0.5 - center) / stretch;
+                v = filter == RESIZE_BICUBIC ? cubicFilter(x) : triangleFilter(x);
+            }
+            w[j - lo] = v;
+            sum += v;
+        }
+        if (sum <= 0.0) continue;   // keeps the nearest sample
+
+        // Zero weights at both ends cost taps for nothing
+        while (lo < hi && w[0] == 0.0) {
+            memmove(w, w + 1, (hi - lo - 1) * sizeof(double));
+            lo++;
+        }
+        while (hi > lo && w[hi - lo - 1] == 0.0) hi--;
+
+        // Fixed point, the rounding error goes to the largest weight so the sum is exactly 1
+        int total = 0, largest = 0;
+        for (int k = 0; k < hi - lo; k++) {
+            q[k] = (int16_t)lround(w[k] / sum * RESIZE_ONE);
+            total += q[k];
+            if (q[k] > q[largest]) largest = k;
+        }
+        q[largest] += RESIZE_ONE - total;
+        t->start[i] = lo;
+        t->count[i] = hi - lo;
+    }
+
+    free(w);
+    return 0;
+}
+
+
+// The rows of the new width keep MID_BITS fractional bits, so the result is rounded only once
+#define MID_BITS 7
+#define MID_MAX (255 << MID_BITS)
+
+
+// One instance of the horizontal pass per number of bytes per pixel, so the channel loop is unrolled
+#define RESIZE_HORIZONTAL(name, CH)                                                         \
+static void name(const uint8_t *src, uint16_t *dst, int dstWidth, const t_resize_table *t) { \
+    const int32_t half = 1 << (RESIZE_BITS - MID_BITS - 1);                                 \
+    for (int x = 0; x < dstWidth; x++) {                                                    \
+        const int16_t *w = t->weights + (size_t)x * t->maxTaps;                             \
+        const uint8_t *s = src + (size_t)t->start[x] * (CH);                                \
+        int32_t acc[4] = {half, half, half, half};                                          \
+        for (int k = 0; k < t->count[x]; k++) {                                             \
+            for (int c = 0; c < (CH); c++) acc[c] += w[k] * s[k * (CH) + c];                \
+        }                                                                                   \
+        for (int c = 0; c < (CH); c++) {                                                    \
+            int32_t v = acc[c] >> (RESIZE_BITS - MID_BITS);                                 \
+            dst[x * (CH) + c] = (uint16_t)(v < 0 ? 0 : v > MID_MAX ? MID_MAX : v);          \
+        }                                                                                   \
+    }                                                                                       \
+}
+
+RESIZE_HORIZONTAL(horizontalRow1, 1)
+RESIZE_HORIZONTAL(horizontalRow3, 3)
+RESIZE_HORIZONTAL(horizontalRow4, 4)
+
+
+// Output rows resized together by one thread : the source rows they share are resized along x only once
+#define RESIZE_BAND 32
+
+
+/// @brief Resizes one source row along x, with the instance for its number of bytes per pixel.
+static void horizontalRow(const uint8_t *src, uint16_t *dst, int dstWidth, const t_resize_table *t, int ch) {
+    if (ch == 1) horizontalRow1(src, dst, dstWidth, t);
+    else if (ch == 3) horizontalRow3(src, dst, dstWidth, t);
+    else horizontalRow4(src, dst, dstWidth, t);
+}
+
+
+/// @brief Resizes every group of rows of a descriptor into the rows of another one. All the bytes of
+/// the pixels are resized (the alpha of BGRA pixels too).
+/// The output rows are computed by bands. Each thread keeps the source rows its band reads, resized
+/// along x, in a ring of maxTaps rows (source row j in slot j % maxTaps), so the memory used doesn't
+/// grow with the height of the image.
+/// @param src Source pixels.
+/// @param dst Output pixels, same format and group count.
+/// @param filter Filter to use.
+/// @return 0 on success, -1 on error.
+static int resizeView(const t_image *src, const t_image *dst, t_resize_filter filter) {
+    int ch = src->pixelStep;
+    t_resize_table tx, ty;
+    if (buildTable(src->width, dst->width, filter, &tx) != 0) return -1;
+    if (buildTable(src->height, dst->height, filter, &ty) != 0) {
+        freeTable(&tx);
+        return -1;
+    }
+
+    size_t midStride = (size_t)dst->width * ch;
+    int span = ty.maxTaps;
+    int bands = (dst->height + RESIZE_BAND - 1) / RESIZE_BAND;
+    const int shift = RESIZE_BITS + MID_BITS;
+    int failed = 0;
+
+    #pragma omp parallel
+    {
+        uint16_t *ring = (uint16_t *)malloc((size_t)span * midStride * sizeof(uint16_t));
+        int *held = (int *)malloc(span * sizeof(int));   // source row in each slot, -1 if none
+        int32_t *acc = (int32_t *)malloc(midStride * sizeof(int32_t));
+        if (!ring || !held || !acc) {
+            #pragma omp atomic write
+            failed = 1;
+        }
+
+        #pragma omp for schedule(dynamic)
+        for (int b = 0; b < dst->groups * bands; b++) {
+            if (!ring || !held || !acc) continue;
+            int g = b / bands, y0 = (b % bands) * RESIZE_BAND;
+            int y1 = y0 + RESIZE_BAND < dst->height ? y0 + RESIZE_BAND : dst->height;
+            uint8_t *const *srcRows = src->rows + (size_t)g * src->height;
+            for (int k = 0; k < span; k++) held[k] = -1;
+
+            for (int y = y0; y < y1; y++) {
+                const int16_t *w = ty.weights + (size_t)y * ty.maxTaps;
+
+                // Vertical pass : whole rows are accumulated at once, a loop the compiler vectorizes
+                for (size_t i = 0; i < midStride; i++) acc[i] = 1 << (shift - 1);
+                for (int k = 0; k < ty.count[y]; k++) {
+                    int j = ty.start[y] + k;
+                    uint16_t *s = ring + (size_t)(j % span) * midStride;
+                    if (held[j % span] != j) {
+                        horizontalRow(srcRows[j], s, dst->width, &tx, ch);
+                        held[j % span] = j;
+                    }
+                    int32_t wk = w[k];
+                    for (size_t i = 0; i < midStride; i++) acc[i] += wk * s[i];
+                }
+
+                uint8_t *out = dst->rows[(size_t)g * dst->height + y];
+                for (size_t i = 0; i < midStride; i++) {
+                    int32_t v = acc[i] >> shift;
+                    out[i] = (uint8_t)(v < 0 ? 0 : v > 255 ? 255 : v);
+                }
+            }
+        }
+        free(ring);
+        free(held);
+        free(acc);
+    }
+
+    freeTable(&tx);
+    freeTable(&ty);
+    if (failed) fprintf(stderr, "Memory allocation failed for resize.\n");
+    return failed ? -1 : 0;
+}
+
+
+/// @brief Resizes an 8-bit image into a new image (same color table, orientation and compression).
+/// @param img Source image (left untouched).
+/// @param width @param height Size of the new image, at least 1.
+/// @param filter RESIZE_NEAREST, RESIZE_BILINEAR, RESIZE_BICUBIC or RESIZE_AREA.
+/// @return The new image, or NULL on error.
+t_bmp8 *bmp8_resize(t_bmp8 *img, int width, int height, t_resize_filter filter) {
+    if (!img || !img->data || width < 1 || height < 1 || img->width < 1 || img->height < 1) return NULL;
+
+    t_bmp8 *out = bmp8_allocate(width, height);
+    if (!out) return NULL;
+    memcpy(out->colorTable, img->colorTable, sizeof(out->colorTable));
+    out->topDown = img->topDown;
+    out->compression = img->compression;
+
+    t_image src, dst;
+    int result = -1;
+    if (image_fromBmp8(img, &src) == 0) {
+        if (image_fromBmp8(out, &dst) == 0) {
+            result = resizeView(&src, &dst, filter);
+            image_free(&dst);
+        }
+        image_free(&src);
+    }
+    if (result != 0) {
+        bmp8_free(out);
+        return NULL;
+    }
+    return out;
+}
+
+
+/// @brief Resizes a 24-bit image into a new image of the same layout and color depth (the alpha of
+/// 32-bit images held in the BGRA layout is resized too).
+/// @param img Source image (left untouched).
+/// @param width @param height Size of the new image, at least 1.
+/// @param filter RESIZE_NEAREST, RESIZE_BILINEAR, RESIZE_BICUBIC or RESIZE_AREA.
+/// @return The new image, or NULL on error.
+t_bmp24 *bmp24_resize(t_bmp24 *img, int width, int height, t_resize_filter filter) {
+    if (!img || width < 1 || height < 1 || img->width < 1 || img->height < 1) return NULL;
+
+    t_bmp24 *out = bmp24_allocateLayout(width, height, img->colorDepth, img->layout);
+    if (!out) return NULL;
+    out->header = img->header;
+    out->header_info = img->header_info;
+    out->topDown = img->topDown;
+    out->header_info.width = width;
+    out->header_info.height = img->topDown ? -height : height;
+
+    t_image src, dst;
+    int result = -1;
+    if (image_fromBmp24(img, &src) == 0) {
+        if (image_fromBmp24(out, &dst) == 0) {
+            result = resizeView(&src, &dst, filter);
+            image_free(&dst);
+        }
+        image_free(&src);
+    }
+    if (result != 0) {
+        bmp24_free(out);
+        return NULL;
+    }
+    return out;
+}
+
+
+/// @brief Computes the largest size that fits in a box while keeping the aspect ratio of an image
+/// (never larger than the image itself), e.g. for thumbnails.
+/// @param width @param height Size of the image.
+/// @param maxWidth @param maxHeight Size of the box.
+/// @param fitWidth @param fitHeight Receive the size, at least 1 x 1.
+void resize_fitSize(int width, int height, int maxWidth, int maxHeight, int *fitWidth, int *fitHeight) {
+    double scale = 1.0;
+    if (width > maxWidth) scale = (double)maxWidth / width;
+    if (height * scale > maxHeight) scale = (double)maxHeight / height;
+
+    *fitWidth = (int)lround(width * scale);
+    *fitHeight = (int)lround(height * scale);
+    if (*fitWidth < 1) *fitWidth = 1;
+    if (*fitHeight < 1) *fitHeight = 1;
+}
+
+
+/// @brief Prepares a box average of a source image into a destination view.
+/// @param box Accumulator to fill, released with resize_boxEnd.
+/// @param dst Output pixels : a single group of rows (8-bit or BGRA), at most the size of the source.
+/// @param srcWidth @param srcHeight Size of the source image.
+/// @return 0 on success, -1 on error.
+int resize_boxBegin(t_resize_box *box, const t_image *dst, int srcWidth, int srcHeight) {
+    if (!box || !dst || dst->groups != 1 || dst->width > srcWidth || dst->height > srcHeight) return -1;
+
+    box->view = *dst;
+    box->srcWidth = srcWidth;
+    box->srcHeight = srcHeight;
+    box->row = -1;
+    box->rowCount = 0;
+    box->column = (int *)malloc(srcWidth * sizeof(int));
+    box->columnCount = (int *)calloc(dst->width, sizeof(int));
+    box->sums = (uint64_t *)malloc((size_t)dst->width * dst->pixelStep * sizeof(uint64_t));
+    if (!box->column || !box->columnCount || !box->sums) {
+        fprintf(stderr, "Memory allocation failed for box resize.\n");
+        free(box->column);
+        free(box->columnCount);
+        free(box->sums);
+        box->column = box->columnCount = NULL;
+        box->sums = NULL;
+        return -1;
+    }
+
+    // Source column x falls in output column x * dstWidth / srcWidth : the boxes differ by at most one column
+    for (int x = 0; x < srcWidth; x++) {
+        box->column[x] = (int)((int64_t)x * dst->width / srcWidth);
+        box->columnCount[box->column[x]]++;
+    }
+    return 0;
+}
+
+
+/// @brief Writes the averages of the output row held by the sums.
+static void boxFlush(t_resize_box *box) {
+    if (box->row < 0 || box->rowCount == 0) return;
+
+    int step = box->view.pixelStep;
+    uint8_t *out = box->view.rows[box->row];
+    for (int x = 0; x < box->view.width; x++) {
+        uint64_t count = (uint64_t)box->columnCount[x] * box->rowCount;
+        for (int c = 0; c < step; c++) {
+            out[x * step + c] = (uint8_t)((box->sums[x * step + c] + count / 2) / count);
+        }
+    }
+}
+
+
+/// @brief Adds a source row to the box average.
+/// @param box Accumulator.
+/// @param y Row of the source image (0 is the top).
+/// @param row Its pixels, in the format of the output view.
+void resize_boxAddRow(t_resize_box *box, int y, const uint8_t *row) {
+    int target = (int)((int64_t)y * box->view.height / box->srcHeight);
+    int step = box->view.pixelStep;
+    if (target != box->row) {
+        boxFlush(box);
+        memset(box->sums, 0, (size_t)box->view.width * step * sizeof(uint64_t));
+        box->row = target;
+        box->rowCount = 0;
+    }
+
+    uint64_t *sums = box->sums;
+    for (int x = 0; x < box->srcWidth; x++) {
+        uint64_t *s = sums + (size_t)box->column[x] * step;
+        for (int c = 0; c < step; c++) s[c] += row[x * step + c];
+    }
+    box->rowCount++;
+}
+
+
+/// @brief Writes the last output row and releases the accumulator.
+/// @param box Accumulator.
+void resize_boxEnd(t_resize_box *box) {
+    if (!box) return;
+    if (box->sums) boxFlush(box);
+    free(box->column);
+    free(box->columnCount);
+    free(box->sums);
+    box->column = box->columnCount = NULL;
+    box->sums = NULL;
+}
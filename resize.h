@@ -0,0 +1,47 @@
+#ifndef RESIZE_H
+#define RESIZE_H
+
+#include "bmp8.h"
+#include "bmp24.h"
+#include "image.h"
+#include <stdint.h>
+
+// -------------------- HEADER ---------------------------
+//  Name : resize.h
+//  Goal : resize 8-bit and 24-bit images with separable fixed-point filters
+//  Authors : Amel Boulhamane and Tom Hausmann
+//
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments
+//
+// --------------------------------------------------------
+
+
+typedef enum {
+    RESIZE_NEAREST,    // nearest source pixel, no filtering
+    RESIZE_BILINEAR,   // triangle filter, widened when downscaling so every source pixel counts
+    RESIZE_BICUBIC,    // Keys cubic (a = -0.5), sharper, widened when downscaling
+    RESIZE_AREA        // exact average of the source area covered by each output pixel (best for thumbnails)
+} t_resize_filter;
+
+// Box average of rows given one at a time, in any order as long as the rows of each output row come
+// together (e.g. the rows of a file as they are read) : only one output row of sums is kept
+typedef struct {
+    t_image view;        // output pixels, a single group of rows
+    int srcWidth;
+    int srcHeight;
+    int *column;         // output column of each source column
+    int *columnCount;    // source columns of each output column
+    uint64_t *sums;      // sums of the output row being accumulated, pixelStep per pixel
+    int row;             // output row held by sums, -1 if none
+    int rowCount;        // source rows added to it
+} t_resize_box;
+
+t_bmp8 *bmp8_resize(t_bmp8 *img, int width, int height, t_resize_filter filter);
+t_bmp24 *bmp24_resize(t_bmp24 *img, int width, int height, t_resize_filter filter);
+void resize_fitSize(int width, int height, int maxWidth, int maxHeight, int *fitWidth, int *fitHeight);
+
+int resize_boxBegin(t_resize_box *box, const t_image *dst, int srcWidth, int srcHeight);
+void resize_boxAddRow(t_resize_box *box, int y, const uint8_t *row);
+void resize_boxEnd(t_resize_box *box);
+
+#endif // RESIZE_H
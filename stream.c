@@ -0,0 +1,374 @@
+#include "stream.h"
+#include "probe.h"
+#include "equalize8.h"
+#include "equalize24.h"
+#include "image.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+// -------------------- HEADER ---------------------------
+//  Name : stream.c
+//  Goal : run point operations, convolutions and equalization on uncompressed 8-bit and 24-bit BMP files
+//         strip by strip, so that memory stays in O(width x strip height) whatever the height of the image
+//  Authors : Amel Boulhamane and Tom Hausmann
+//
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments
+//
+// --------------------------------------------------------
+//
+// Rows go through the operations one at a time, in the order of the file. A convolution of size 2n+1 keeps the
+// last 2n+1 rows it received (the halo) and gives back row r - n when row r arrives, so every stage lags a few
+// rows behind the previous one and the remaining rows are flushed at the end of the file.
+// Equalization needs the histogram of the whole image : it is computed by an extra pass over the file, which runs
+// the operations placed before it and only counts. The output is written by the last pass.
+
+
+// State of one operation of the chain
+typedef struct {
+    t_stream_op op;
+    int n;               // convolution : half size of the kernel, rows of delay
+    uint8_t *ring;       // convolution : the last 2n+1 rows received
+    int received;        // rows received during the current pass
+    uint8_t *out;        // row given to the next operation
+    uint8_t map[256];    // lookup table of point operations and equalization
+    unsigned int hist[256]; // equalization : histogram counted by its pass
+    int ready;           // equalization : map computed
+} t_stream_stage;
+
+// The file and the chain being run
+typedef struct {
+    FILE *in;
+    FILE *out;           // NULL during the passes that only count
+    int width, height;
+    int topDown;
+    int channels;        // 1 for 8-bit files, 3 for 24-bit files
+    size_t rowSize;      // bytes per row in the file, padding included
+    uint32_t offset;     // start of the pixels
+    t_stream_stage *stages;
+    int active;          // stages run by the current pass
+    uint8_t *inStrip;    // stripHeight rows read at once
+    uint8_t *strip;      // stripHeight rows written at once
+    int stripHeight;
+    int stripRows;       // rows waiting in the output strip
+} t_stream;
+
+
+/// @brief Opens the input file, checks that it can be streamed and copies its headers to the output.
+/// @param s Stream to fill.
+/// @param input Path of the input file.
+/// @param output Path of the output file.
+/// @return 0 on success, -1 on error.
+static int openStream(t_stream *s, const char *input, const char *output) {
+    s->in = fopen(input, "rb");
+    if (!s->in) {
+        fprintf(stderr, "Error: Cannot open file %s\n", input);
+        return -1;
+    }
+
+    unsigned char header[BMP_HEADER_SIZE];
+    t_bmp_header fileHeader;
+    t_bmp_info info;
+    if (bmp_readHeader(s->in, header, &fileHeader, &info) != 0) return -1;
+
+    int32_t width = info.width;
+    int32_t height = info.height;
+    int bits = info.bits;
+    uint32_t compression = info.compression;
+    s->offset = fileHeader.offset;
+
+    if ((bits != 8 && bits != 24) || compression != 0) {
+        fprintf(stderr, "Error: Only uncompressed 8-bit and 24-bit BMP files can be streamed\n");
+        return -1;
+    }
+    if (width <= 0 || height == 0 || s->offset < BMP_HEADER_SIZE) {
+        fprintf(stderr, "Error: Invalid BMP dimensions\n");
+        return -1;
+    }
+
+    s->width = width;
+    s->height = height < 0 ? -height : height;
+    s->topDown = height < 0;
+    s->channels = bits / 8;
+    s->rowSize = ((size_t)width * s->channels + 3) & ~(size_t)3;
+
+    // Everything before the pixels (headers, palette) is kept as it is : the size of the image does not change
+    s->out = fopen(output, "wb");
+    if (!s->out) {
+        fprintf(stderr, "Error: Cannot create file %s\n", output);
+        return -1;
+    }
+    fwrite(header, 1, BMP_HEADER_SIZE, s->out);
+    uint8_t buffer[1024];
+    for (uint32_t done = BMP_HEADER_SIZE; done < s->offset;) {
+        size_t chunk = s->offset - done < sizeof(buffer) ? s->offset - done : sizeof(buffer);
+        if (fread(buffer, 1, chunk, s->in) != chunk) {
+            fprintf(stderr, "Error: Truncated BMP header\n");
+            return -1;
+        }
+        fwrite(buffer, 1, chunk, s->out);
+        done += chunk;
+    }
+    return 0;
+}
+
+
+/// @brief Adds a row to the output strip, writing the strip when it is full.
+/// @return 0 on success, -1 on a write error.
+static int writeRow(t_stream *s, const uint8_t *row) {
+    memcpy(s->strip + (size_t)s->stripRows * s->rowSize, row, s->rowSize);
+    if (++s->stripRows == s->stripHeight) {
+        if (fwrite(s->strip, s->rowSize, s->stripRows, s->out) != (size_t)s->stripRows) return -1;
+        s->stripRows = 0;
+    }
+    return 0;
+}
+
+
+/// @brief Computes row m of a convolution from the rows held by its ring.
+/// @param s The stream.
+/// @param st The convolution stage.
+/// @param m Row of the file to compute.
+static void convolveRow(t_stream *s, t_stream_stage *st, int m) {
+    int n = st->n, size = 2 * n + 1;
+    int w = s->width, c = s->channels;
+    const float *kernel = st->op.kernel;
+
+    // Rows of the window, from the top of the image : the file order is reversed for bottom-up files
+    const uint8_t *window[size];
+    for (int k = 0; k < size; k++) {
+        int r = s->topDown ? m - n + k : m + n - k;
+        window[k] = st->ring + (size_t)(r % size) * s->rowSize;
+    }
+
+    memcpy(st->out, window[n], s->rowSize);
+
+    // The pixels of a file row : gray levels, or blue, green, red. The results are brought back to bytes like
+    // the in-memory filters do : truncated for 8-bit files, rounded for 24-bit ones
+    t_image view = {c == 1 ? IMAGE_GRAY8 : IMAGE_RGB24, NULL, 1, w, s->height, c, c};
+    image_convolveRow(window, st->out, &view, kernel, size, n, c == 1 ? IMAGE_TRUNCATE : IMAGE_ROUND);
+}
+
+
+static int pushRow(t_stream *s, int k, const uint8_t *row);
+
+
+/// @brief Gives row r of the file, held by the ring of a convolution, unchanged to the next stage.
+static int passRingRow(t_stream *s, int k, int r) {
+    t_stream_stage *st = &s->stages[k];
+    return pushRow(s, k + 1, st->ring + (size_t)(r % (2 * st->n + 1)) * s->rowSize);
+}
+
+
+/// @brief Runs a row through stage k and the ones after it.
+/// @param s The stream.
+/// @param k Index of the stage receiving the row.
+/// @param row The row, in the order of the file.
+/// @return 0 on success, -1 on a write error.
+static int pushRow(t_stream *s, int k, const uint8_t *row) {
+    if (k == s->active) return s->out ? writeRow(s, row) : 0;
+
+    t_stream_stage *st = &s->stages[k];
+    int w = s->width, c = s->channels;
+
+    if (st->op.type == STREAM_CONVOLUTION) {
+        int n = st->n, r = st->received++;
+        memcpy(st->ring + (size_t)(r % (2 * n + 1)) * s->rowSize, row, s->rowSize);
+        // The first n rows are a border : they leave unchanged right away
+        if (r < n) return passRingRow(s, k, r);
+        if (r >= 2 * n && r - n < s->height - n) {
+            convolveRow(s, st, r - n);
+            return pushRow(s, k + 1, st->out);
+        }
+        return 0;
+    }
+
+    if (st->op.type == STREAM_EQUALIZE && !st->ready) {
+        // Counting pass : nothing goes further
+        for (int x = 0; x < w; x++) {
+            const uint8_t *p = row + x * c;
+            st->hist[c == 1 ? p[0] : bmp24_lumaIndex(p[2], p[1], p[0])]++;
+        }
+        return 0;
+    }
+
+    memcpy(st->out, row, s->rowSize);
+    if (st->op.type == STREAM_EQUALIZE && c == 3) {
+        for (int x = 0; x < w; x++) {
+            uint8_t *p = st->out + x * 3;
+            bmp24_equalizePixel(&p[2], &p[1], &p[0], st->map);
+        }
+    } else {
+        for (int i = 0; i < w * c; i++) st->out[i] = st->map[st->out[i]];
+    }
+    return pushRow(s, k + 1, st->out);
+}
+
+
+/// @brief Gives the rows still held by the convolutions at the end of the file.
+/// @return 0 on success, -1 on a write error.
+static int flushStages(t_stream *s) {
+    for (int k = 0; k < s->active; k++) {
+        t_stream_stage *st = &s->stages[k];
+        if (st->op.type != STREAM_CONVOLUTION) continue;
+
+        // The last n rows are a border (all the rows left when the image is smaller than the kernel)
+        int first = s->height - st->n > st->n ? s->height - st->n : st->n;
+        for (int r = first; r < s->height; r++) {
+            if (passRingRow(s, k, r) != 0) return -1;
+        }
+    }
+    return 0;
+}
+
+
+/// @brief Reads the pixels of the file strip by strip and runs them through the active stages.
+/// @return 0 on success, -1 on error.
+static int runPass(t_stream *s) {
+    for (int k = 0; k < s->active; k++) s->stages[k].received = 0;
+    s->stripRows = 0;
+
+    if (fseek(s->in, s->offset, SEEK_SET) != 0) {
+        fprintf(stderr, "Error: Cannot seek to the pixel data\n");
+        return -1;
+    }
+
+    for (int done = 0; done < s->height;) {
+        int count = s->height - done < s->stripHeight ? s->height - done : s->stripHeight;
+        if (fread(s->inStrip, s->rowSize, count, s->in) != (size_t)count) {
+            fprintf(stderr, "Error: Truncated BMP pixel data\n");
+            return -1;
+        }
+        for (int i = 0; i < count; i++) {
+            if (pushRow(s, 0, s->inStrip + (size_t)i * s->rowSize) != 0) goto write_error;
+        }
+        done += count;
+    }
+    if (flushStages(s) != 0) goto write_error;
+
+    if (s->out && s->stripRows > 0 &&
+        fwrite(s->strip, s->rowSize, s->stripRows, s->out) != (size_t)s->stripRows) goto write_error;
+    return 0;
+
+write_error:
+    fprintf(stderr, "Error: Cannot write the output file\n");
+    return -1;
+}
+
+
+/// @brief Prepares the state of every operation.
+/// @return 0 on success, -1 on error.
+static int setupStages(t_stream *s, const t_stream_op *ops, int opCount) {
+    s->stages = calloc(opCount, sizeof(t_stream_stage));
+    if (!s->stages) return -1;
+
+    for (int k = 0; k < opCount; k++) {
+        t_stream_stage *st = &s->stages[k];
+        st->op = ops[k];
+        st->out = malloc(s->rowSize);
+        if (!st->out) return -1;
+
+        switch (ops[k].type) {
+            case STREAM_NEGATIVE:
+                for (int v = 0; v < 256; v++) st->map[v] = (uint8_t)(255 - v);
+                break;
+            case STREAM_BRIGHTNESS:
+                for (int v = 0; v < 256; v++) {
+                    int value = v + ops[k].value;
+                    st->map[v] = (uint8_t)(value < 0 ? 0 : value > 255 ? 255 : value);
+                }
+                break;
+            case STREAM_THRESHOLD:
+                for (int v = 0; v < 256; v++) st->map[v] = v >= ops[k].value ? 255 : 0;
+                break;
+            case STREAM_CONVOLUTION:
+                if (!ops[k].kernel || ops[k].kernelSize < 1 || ops[k].kernelSize % 2 == 0) {
+                    fprintf(stderr, "Error: Invalid kernel size %d\n", ops[k].kernelSize);
+                    return -1;
+                }
+                st->n = ops[k].kernelSize / 2;
+                st->ring = malloc((size_t)ops[k].kernelSize * s->rowSize);
+                if (!st->ring) return -1;
+                break;
+            case STREAM_EQUALIZE:
+                break;
+            default:
+                fprintf(stderr, "Error: Unknown stream operation %d\n", (int)ops[k].type);
+                return -1;
+        }
+    }
+    return 0;
+}
+
+
+/// @brief Applies a chain of operations to a BMP file, strip by strip, and writes the result to another file.
+/// Only stripHeight rows, plus the halo rows of the convolutions, are in memory at a time.
+/// Each equalization adds one pass over the input file.
+/// @param input Path of an uncompressed 8-bit or 24-bit BMP file.
+/// @param output Path of the result, with the same headers and row order as the input.
+/// @param ops Operations, applied in order.
+/// @param opCount Number of operations.
+/// @param stripHeight Rows read and written at once (STREAM_STRIP_HEIGHT if 0 or less).
+/// @return 0 on success, -1 on error.
+int bmp_streamProcess(const char *input, const char *output, const t_stream_op *ops, int opCount, int stripHeight) {
+    if (!input || !output || (opCount > 0 && !ops) || opCount < 0) {
+        fprintf(stderr, "Error: Invalid stream arguments\n");
+        return -1;
+    }
+
+    t_stream s;
+    memset(&s, 0, sizeof(s));
+    int status = -1;
+
+    if (openStream(&s, input, output) != 0) goto cleanup;
+    s.stripHeight = stripHeight > 0 ? stripHeight : STREAM_STRIP_HEIGHT;
+    s.inStrip = malloc((size_t)s.stripHeight * s.rowSize);
+    s.strip = malloc((size_t)s.stripHeight * s.rowSize);
+    if (!s.inStrip || !s.strip || setupStages(&s, ops, opCount) != 0) {
+        fprintf(stderr, "Error: Memory allocation failed\n");
+        goto cleanup;
+    }
+
+    // One counting pass per equalization, up to it, then the pass that writes the result
+    FILE *out = s.out;
+    for (int k = 0; k < opCount; k++) {
+        t_stream_stage *st = &s.stages[k];
+        if (st->op.type != STREAM_EQUALIZE) continue;
+
+        s.out = NULL;
+        s.active = k + 1;
+        memset(st->hist, 0, sizeof(st->hist));
+        int failed = runPass(&s);
+        s.out = out;
+        if (failed) goto cleanup;
+
+        unsigned int total = (unsigned int)s.width * s.height;
+        if (s.channels == 3) {
+            bmp24_computeEqualizeMap(st->hist, total, st->map);
+        } else {
+            unsigned int *cdf = bmp8_computeCDF(st->hist, total);
+            if (!cdf) goto cleanup;
+            for (int v = 0; v < 256; v++) st->map[v] = (uint8_t)cdf[v];
+            free(cdf);
+        }
+        st->ready = 1;
+    }
+
+    s.active = opCount;
+    status = runPass(&s);
+
+cleanup:
+    if (s.stages) {
+        for (int k = 0; k < opCount; k++) {
+            free(s.stages[k].ring);
+            free(s.stages[k].out);
+        }
+        free(s.stages);
+    }
+    free(s.inStrip);
+    free(s.strip);
+    if (s.in) fclose(s.in);
+    if (s.out && fclose(s.out) != 0) status = -1;
+    return status;
+}
@@ -0,0 +1,35 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+// -------------------- HEADER ---------------------------
+//  Name : stream.h
+//  Goal : process BMP files strip by strip, for images that do not fit in memory
+//  Authors : Amel Boulhamane and Tom Hausmann
+//
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments
+//
+// --------------------------------------------------------
+
+
+// Operations that can be chained in a stream
+typedef enum {
+    STREAM_NEGATIVE,     // 255 - value on every channel
+    STREAM_BRIGHTNESS,   // adds value, clamped to [0, 255]
+    STREAM_THRESHOLD,    // 255 if the sample is >= value, 0 otherwise
+    STREAM_CONVOLUTION,  // kernel of kernelSize x kernelSize, rows listed from the top
+    STREAM_EQUALIZE      // histogram equalization (gray levels, or luminance for color files), needs one extra pass
+} t_stream_op_type;
+
+typedef struct {
+    t_stream_op_type type;
+    int value;            // brightness offset or threshold
+    const float *kernel;  // convolution only : kernelSize * kernelSize values, row by row
+    int kernelSize;       // convolution only : odd size
+} t_stream_op;
+
+// Default number of rows read and written at once
+#define STREAM_STRIP_HEIGHT 64
+
+int bmp_streamProcess(const char *input, const char *output, const t_stream_op *ops, int opCount, int stripHeight);
+
+#endif // STREAM_H
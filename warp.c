@@ -0,0 +1,284 @@
+#include "warp.h"
+#include "image.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// -------------------- HEADER ---------------------------
+//  Name : warp.c
+//  Goal : affine transforms (rotation by any angle, shear, scale, translation) of 8-bit and 24-bit images
+//         with bilinear sampling, e.g. to deskew scanned pages
+//  Authors : Amel Boulhamane and Tom Hausmann
+//
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments
+//
+// --------------------------------------------------------
+//
+// Every output pixel is sampled from the source at the inverse transform of its center. Along an output row
+// that point moves by a constant step, so it is stepped in 16.16 fixed point instead of multiplying by the
+// matrix. The output is cut in tiles : each tile row restarts from an exact position (the stepping error
+// stays far below 1/256 pixel), and the source area a tile reads stays in cache.
+
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Side of the output tiles, in pixels
+#define WARP_TILE 64
+
+// Fractional bits of the source coordinates, and of the bilinear weights
+#define WARP_BITS 16
+#define WARP_WEIGHT_BITS 8
+
+
+/// @brief Sets a transform to the identity.
+void affine_identity(t_affine *a) {
+    memset(a, 0, sizeof(*a));
+    a->m[0][0] = 1.0;
+    a->m[1][1] = 1.0;
+}
+
+
+/// @brief Sets a transform to a translation.
+/// @param tx @param ty Offset in pixels.
+void affine_translate(t_affine *a, double tx, double ty) {
+    affine_identity(a);
+    a->m[0][2] = tx;
+    a->m[1][2] = ty;
+}
+
+
+/// @brief Sets a transform to a scaling from the origin (top-left corner).
+/// @param sx @param sy Factors along x and y.
+void affine_scale(t_affine *a, double sx, double sy) {
+    affine_identity(a);
+    a->m[0][0] = sx;
+    a->m[1][1] = sy;
+}
+
+
+/// @brief Sets a transform to a shear from the origin : x' = x + shx y, y' = y + shy x.
+void affine_shear(t_affine *a, double shx, double shy) {
+    affine_identity(a);
+    a->m[0][1] = shx;
+    a->m[1][0] = shy;
+}
+
+
+/// @brief Sets a transform to a rotation around a point. As y points down, a positive angle turns the image
+/// clockwise on screen.
+/// @param degrees Angle in degrees.
+/// @param cx @param cy Center of the rotation, e.g. (width / 2, height / 2).
+void affine_rotate(t_affine *a, double degrees, double cx, double cy) {
+    double r = degrees * M_PI / 180.0, c = cos(r), s = sin(r);
+    a->m[0][0] = c;
+    a->m[0][1] = -s;
+    a->m[0][2] = cx - c * cx + s * cy;
+    a->m[1][0] = s;
+    a->m[1][1] = c;
+    a->m[1][2] = cy - s * cx - c * cy;
+}
+
+
+/// @brief Composes two transforms : result applies first, then then. result may be first or then.
+void affine_compose(const t_affine *first, const t_affine *then, t_affine *result) {
+    t_affine r;
+    for (int i = 0; i < 2; i++) {
+        for (int j = 0; j < 3; j++) {
+            r.m[i][j] = then->m[i][0] * first->m[0][j] + then->m[i][1] * first->m[1][j];
+        }
+        r.m[i][2] += then->m[i][2];
+    }
+    *result = r;
+}
+
+
+/// @brief Computes the inverse of a transform.
+/// @param a Transform to invert.
+/// @param inverse Receives the inverse, may be a.
+/// @return 0 on success, -1 if the transform is not invertible (it flattens the image).
+int affine_invert(const t_affine *a, t_affine *inverse) {
+    double det = a->m[0][0] * a->m[1][1] - a->m[0][1] * a->m[1][0];
+    if (fabs(det) < 1e-12) return -1;
+
+    t_affine r;
+    r.m[0][0] = a->m[1][1] / det;
+    r.m[0][1] = -a->m[0][1] / det;
+    r.m[1][0] = -a->m[1][0] / det;
+    r.m[1][1] = a->m[0][0] / det;
+    r.m[0][2] = -(r.m[0][0] * a->m[0][2] + r.m[0][1] * a->m[1][2]);
+    r.m[1][2] = -(r.m[1][0] * a->m[0][2] + r.m[1][1] * a->m[1][2]);
+    *inverse = r;
+    return 0;
+}
+
+
+// One instance of the tile sampler per pixel size, so the channel loops are unrolled. The source
+// positions u, v are biased by one pixel so that every position that can still reach the image is
+// positive : the sample is then between pixels (u >> 16) - 1 and (u >> 16) (minus the half pixel of
+// the centers, also folded in the bias). Outside neighbors take the background value, so edges are smooth.
+#define WARP_TILE_SAMPLE(name, ES)                                                                       \
+static void name(const t_image *src, const t_image *dst, int group, const t_affine *inv,                  \
+                 int x0, int y0, int x1, int y1, const uint8_t *background) {                             \
+    const int64_t one = (int64_t)1 << WARP_BITS;                                                          \
+    const int64_t du = llround(inv->m[0][0] * one), dv = llround(inv->m[1][0] * one);                     \
+    const int64_t limitU = (int64_t)(src->width + 1) << WARP_BITS;                                        \
+    const int64_t limitV = (int64_t)(src->height + 1) << WARP_BITS;                                       \
+    const int shift = WARP_BITS - WARP_WEIGHT_BITS, mask = (1 << WARP_WEIGHT_BITS) - 1;                   \
+    /* Positions are rounded to the weight precision rather than truncated : the pixel, the */            \
+    /* weights and the inside test all use the position plus half a weight step */                        \
+    const int64_t half = (int64_t)1 << (shift - 1);                                                       \
+    uint8_t *const *rows = src->rows + (size_t)group * src->height;                                        \
+                                                                                                           \
+    for (int y = y0; y < y1; y++) {                                                                        \
+        double cx = x0 + 0.5, cy = y + 0.5;                                                                \
+        int64_t u = llround((inv->m[0][0] * cx + inv->m[0][1] * cy + inv->m[0][2] + 0.5) * one) + half;   \
+        int64_t v = llround((inv->m[1][0] * cx + inv->m[1][1] * cy + inv->m[1][2] + 0.5) * one) + half;   \
+        uint8_t *out = dst->rows[(size_t)group * dst->height + y] + (size_t)x0 * (ES);                     \
+                                                                                                           \
+        for (int x = x0; x < x1; x++, u += du, v += dv, out += (ES)) {                                     \
+            if (u < 0 || v < 0 || u >= limitU || v >= limitV) {                                            \
+                memcpy(out, background, (ES));                                                             \
+                continue;                                                                                  \
+            }                                                                                              \
+            int sx = (int)(u >> WARP_BITS) - 1, sy = (int)(v >> WARP_BITS) - 1;                            \
+            int wx = (int)(u >> shift) & mask, wy = (int)(v >> shift) & mask;                              \
+            int ix = (1 << WARP_WEIGHT_BITS) - wx, iy = (1 << WARP_WEIGHT_BITS) - wy;                      \
+                                                                                                           \
+            if (sx >= 0 && sy >= 0 && sx < src->width - 1 && sy < src->height - 1) {                       \
+                const uint8_t *p = rows[sy] + (size_t)sx * (ES), *q = rows[sy + 1] + (size_t)sx * (ES);    \
+                for (int c = 0; c < (ES); c++) {                                                           \
+                    int top = p[c] * ix + p[(ES) + c] * wx, bottom = q[c] * ix + q[(ES) + c] * wx;         \
+                    out[c] = (uint8_t)((top * iy + bottom * wy + (1 << (2 * WARP_WEIGHT_BITS - 1)))        \
+                                       >> (2 * WARP_WEIGHT_BITS));                                         \
+                }                                                                                          \
+            } else {                                                                                       \
+                /* At the border : the missing neighbors are the background */                            \
+                int inX0 = sx >= 0, inX1 = sx + 1 < src->width, inY0 = sy >= 0, inY1 = sy + 1 < src->height; \
+                for (int c = 0; c < (ES); c++) {                                                           \
+                    int p0 = inX0 && inY0 ? rows[sy][(size_t)sx * (ES) + c] : background[c];               \
+                    int p1 = inX1 && inY0 ? rows[sy][(size_t)(sx + 1) * (ES) + c] : background[c];         \
+                    int q0 = inX0 && inY1 ? rows[sy + 1][(size_t)sx * (ES) + c] : background[c];           \
+                    int q1 = inX1 && inY1 ? rows[sy + 1][(size_t)(sx + 1) * (ES) + c] : background[c];     \
+                    int top = p0 * ix + p1 * wx, bottom = q0 * ix + q1 * wx;                               \
+                    out[c] = (uint8_t)((top * iy + bottom * wy + (1 << (2 * WARP_WEIGHT_BITS - 1)))        \
+                                       >> (2 * WARP_WEIGHT_BITS));                                         \
+                }                                                                                          \
+            }                                                                                              \
+        }                                                                                                  \
+    }                                                                                                      \
+}
+
+WARP_TILE_SAMPLE(sampleTile1, 1)
+WARP_TILE_SAMPLE(sampleTile3, 3)
+WARP_TILE_SAMPLE(sampleTile4, 4)
+
+
+/// @brief Fills the output pixels with the source transformed by a, tile by tile.
+/// @param src Source pixels.
+/// @param dst Output pixels, same format.
+/// @param a Transform from the source to the output.
+/// @param background Value of the pixels outside the source, one byte per byte of a pixel (per group for
+/// the planar format).
+/// @return 0 on success, -1 if the transform is not invertible.
+static int warpView(const t_image *src, const t_image *dst, const t_affine *a, const uint8_t background[4]) {
+    t_affine inv;
+    if (affine_invert(a, &inv) != 0) {
+        fprintf(stderr, "Error: The transform is not invertible.\n");
+        return -1;
+    }
+
+    int es = src->pixelStep;
+    int tileRows = (dst->height + WARP_TILE - 1) / WARP_TILE;
+    #pragma omp parallel for schedule(dynamic)
+    for (int t = 0; t < dst->groups * tileRows; t++) {
+        int group = t / tileRows;
+        int y0 = (t % tileRows) * WARP_TILE;
+        int y1 = y0 + WARP_TILE < dst->height ? y0 + WARP_TILE : dst->height;
+        const uint8_t *bg = dst->groups > 1 ? background + group : background;
+        for (int x0 = 0; x0 < dst->width; x0 += WARP_TILE) {
+            int x1 = x0 + WARP_TILE < dst->width ? x0 + WARP_TILE : dst->width;
+            if (es == 1) sampleTile1(src, dst, group, &inv, x0, y0, x1, y1, bg);
+            else if (es == 3) sampleTile3(src, dst, group, &inv, x0, y0, x1, y1, bg);
+            else sampleTile4(src, dst, group, &inv, x0, y0, x1, y1, bg);
+        }
+    }
+    return 0;
+}
+
+
+/// @brief Transforms an 8-bit image into a new image (same color table, orientation and compression).
+/// @param img Source image (left untouched).
+/// @param a Transform from the source to the output, e.g. affine_rotate around the center to deskew.
+/// @param width @param height Size of the new image (the size of img keeps the page size).
+/// @param background Value of the pixels that come from outside the source.
+/// @return The new image, or NULL on error.
+t_bmp8 *bmp8_warp(t_bmp8 *img, const t_affine *a, int width, int height, uint8_t background) {
+    if (!img || !img->data || !a || width < 1 || height < 1) return NULL;
+
+    t_bmp8 *out = bmp8_allocate(width, height);
+    if (!out) return NULL;
+    memcpy(out->colorTable, img->colorTable, sizeof(out->colorTable));
+    out->topDown = img->topDown;
+    out->compression = img->compression;
+
+    uint8_t bg[4] = {background, background, background, background};
+    t_image src, dst;
+    int result = -1;
+    if (image_fromBmp8(img, &src) == 0) {
+        if (image_fromBmp8(out, &dst) == 0) {
+            result = warpView(&src, &dst, a, bg);
+            image_free(&dst);
+        }
+        image_free(&src);
+    }
+    if (result != 0) {
+        bmp8_free(out);
+        return NULL;
+    }
+    return out;
+}
+
+
+/// @brief Transforms a 24-bit image into a new image of the same layout and color depth (the alpha of
+/// BGRA pixels is sampled too, the background is opaque).
+/// @param img Source image (left untouched).
+/// @param a Transform from the source to the output, e.g. affine_rotate around the center to deskew.
+/// @param width @param height Size of the new image (the size of img keeps the page size).
+/// @param background Color of the pixels that come from outside the source.
+/// @return The new image, or NULL on error.
+t_bmp24 *bmp24_warp(t_bmp24 *img, const t_affine *a, int width, int height, t_pixel background) {
+    if (!img || !a || width < 1 || height < 1) return NULL;
+
+    t_bmp24 *out = bmp24_allocateLayout(width, height, img->colorDepth, img->layout);
+    if (!out) return NULL;
+    out->header = img->header;
+    out->header_info = img->header_info;
+    out->topDown = img->topDown;
+    out->header_info.width = width;
+    out->header_info.height = img->topDown ? -height : height;
+
+    // The background in the byte order of the layout : BGRA pixels, or red, green, blue (pixels or planes)
+    uint8_t bg[4] = {background.red, background.green, background.blue, 255};
+    if (img->layout == BMP24_BGRA) {
+        bg[0] = background.blue;
+        bg[2] = background.red;
+    }
+
+    t_image src, dst;
+    int result = -1;
+    if (image_fromBmp24(img, &src) == 0) {
+        if (image_fromBmp24(out, &dst) == 0) {
+            result = warpView(&src, &dst, a, bg);
+            image_free(&dst);
+        }
+        image_free(&src);
+    }
+    if (result != 0) {
+        bmp24_free(out);
+        return NULL;
+    }
+    return out;
+}
@@ -0,0 +1,36 @@
+#ifndef WARP_H
+#define WARP_H
+
+#include <stdint.h>
+#include "bmp8.h"
+#include "bmp24.h"
+
+// -------------------- HEADER ---------------------------
+//  Name : warp.h
+//  Goal : affine transforms (rotation by any angle, shear, scale, translation) of 8-bit and 24-bit images
+//         with bilinear sampling, e.g. to deskew scanned pages
+//  Authors : Amel Boulhamane and Tom Hausmann
+//
+/// NOTE : Throughout the files, we use the @brief, @param and @return structure for more consistency in the comments
+//
+// --------------------------------------------------------
+
+
+// Maps a point of the source image to the output : x' = m[0][0] x + m[0][1] y + m[0][2], y' = m[1][0] x + m[1][1] y + m[1][2].
+// Coordinates are in pixels, x to the right and y down, pixel (i, j) covering [i, i + 1] x [j, j + 1].
+typedef struct {
+    double m[2][3];
+} t_affine;
+
+void affine_identity(t_affine *a);
+void affine_translate(t_affine *a, double tx, double ty);
+void affine_scale(t_affine *a, double sx, double sy);
+void affine_shear(t_affine *a, double shx, double shy);
+void affine_rotate(t_affine *a, double degrees, double cx, double cy);
+void affine_compose(const t_affine *first, const t_affine *then, t_affine *result);
+int affine_invert(const t_affine *a, t_affine *inverse);
+
+t_bmp8 *bmp8_warp(t_bmp8 *img, const t_affine *a, int width, int height, uint8_t background);
+t_bmp24 *bmp24_warp(t_bmp24 *img, const t_affine *a, int width, int height, t_pixel background);
+
+#endif // WARP_H